@@ -87,6 +87,7 @@ int main(int argc, char* argv[])
 		delete config;
 		delete( core );
 		Log(MESSAGE, "Main", "Press enter to continue...");
+		FlushLog();
 		getc(stdin);
 		ShutdownLogging();
 		return -1;
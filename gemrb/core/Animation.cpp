@@ -54,8 +54,9 @@ Animation::Animation(int count)
 
 Animation::~Animation(void)
 {
+	// frames may be left empty, eg. by lazily decoded tiles
 	for (unsigned int i = 0; i < indicesCount; i++) {
-		frames[i]->release();
+		Sprite2D::FreeSprite(frames[i]);
 	}
 	free(frames);
 }
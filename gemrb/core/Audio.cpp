@@ -24,6 +24,9 @@ namespace GemRB {
 
 const TypeID Audio::ID = { "Audio" };
 
+int Audio::decodeLatency = 0;
+size_t Audio::cacheSize = 16 * 1024 * 1024;
+
 Audio::Audio(void)
 {
 	ambim = NULL;
@@ -33,6 +36,17 @@ Audio::~Audio(void)
 {
 }
 
+void Audio::SetDecodeLatency(int ms)
+{
+	decodeLatency = ms > 0 ? ms : 0;
+}
+
+void Audio::SetCacheSize(int kb)
+{
+	// 0 keeps all of them, like the other caches
+	cacheSize = kb > 0 ? (size_t) kb * 1024 : (size_t) -1;
+}
+
 SoundHandle::~SoundHandle()
 {
 }
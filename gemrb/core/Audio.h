@@ -33,6 +33,7 @@ namespace GemRB {
 #define GEM_SND_LOOPING 2
 #define GEM_SND_SPEECH   IE_STR_SPEECH // 4
 #define GEM_SND_QUEUE	8
+#define GEM_SND_SKIP_LATE 16 // drop an effect still decoding rather than play it late
 
 #define GEM_SND_VOL_MUSIC    1
 #define GEM_SND_VOL_AMBIENTS 2
@@ -58,6 +59,10 @@ public:
 	virtual bool Init(void) = 0;
 	virtual Holder<SoundHandle> Play(const char* ResRef, int XPos, int YPos, unsigned int flags = 0, unsigned int *length = 0) = 0;
 	virtual Holder<SoundHandle> Play(const char* ResRef, unsigned int *length = 0) { return Play(ResRef, 0, 0, GEM_SND_RELATIVE, length); }
+	/** Starts decoding a sound in the background, so it is ready when played */
+	virtual void Preload(const char* /*ResRef*/) {}
+	/** Called once a frame, starts the sounds whose decode has finished */
+	virtual void Update() {}
 	virtual AmbientMgr* GetAmbientMgr() { return ambim; }
 	virtual void UpdateVolume(unsigned int flags = GEM_SND_VOL_MUSIC | GEM_SND_VOL_AMBIENTS) = 0;
 	virtual bool CanPlay() = 0;
@@ -78,8 +83,17 @@ public:
 	virtual void QueueBuffer(int stream, unsigned short bits,
 				int channels, short* memory, int size, int samplerate) = 0;
 
+	/** Sets how many milliseconds Play() waits for sound effects decoded
+	 * in the background before it returns and leaves them to start once
+	 * decoded, 0 to decode when played */
+	static void SetDecodeLatency(int ms);
+	/** Sets how many kilobytes of decoded sound effects may be kept, 0 for no limit */
+	static void SetCacheSize(int kb);
+
 protected:
 	AmbientMgr* ambim;
+	static int decodeLatency;
+	static size_t cacheSize;
 
 };
 
@@ -0,0 +1,139 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2016 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "Effect.h"
+
+#include "System/Threading.h"
+
+#include <new>
+
+// For debugging:
+// time the pool against the heap on the first effect and log the speed
+//#define BENCHMARK_EFFECTS
+
+#ifdef BENCHMARK_EFFECTS
+#include "globals.h"
+
+#include <vector>
+#endif
+
+namespace GemRB {
+
+// effects per slab, a slab is never given back, its effects are reused
+#define EFFECT_SLAB_SIZE 256
+
+// the unused effects are chained through their first bytes
+union FreeEffect {
+	FreeEffect* next;
+	char effect[sizeof(Effect)];
+};
+
+static FreeEffect* freeEffects = NULL;
+// effects may be created while loading in the background too
+static Mutex effectPoolLock;
+
+#ifdef BENCHMARK_EFFECTS
+// a mass fireball: every cast creates a few hundred effects (damage, burning,
+// morale and so on for each creature hit), which then expire in another order
+#define BENCHMARK_CASTS 2000
+#define BENCHMARK_EFFECTS_PER_CAST 300
+
+static unsigned __int64 BenchmarkCasts(void* (*alloc)(size_t), void (*release)(void*, size_t))
+{
+	std::vector<void*> effects(BENCHMARK_EFFECTS_PER_CAST);
+	unsigned __int64 start = GetMicroTicks();
+	for (int cast = 0; cast < BENCHMARK_CASTS; cast++) {
+		for (int i = 0; i < BENCHMARK_EFFECTS_PER_CAST; i++) {
+			effects[i] = alloc(sizeof(Effect));
+		}
+		// the odd ones are the short timed effects, they go first
+		for (int i = 1; i < BENCHMARK_EFFECTS_PER_CAST; i += 2) {
+			release(effects[i], sizeof(Effect));
+		}
+		for (int i = 0; i < BENCHMARK_EFFECTS_PER_CAST; i += 2) {
+			release(effects[i], sizeof(Effect));
+		}
+	}
+	return GetMicroTicks() - start;
+}
+
+static void* HeapAlloc(size_t size)
+{
+	return ::operator new(size);
+}
+
+static void HeapRelease(void* ptr, size_t)
+{
+	::operator delete(ptr);
+}
+
+static void BenchmarkEffectPool()
+{
+	unsigned __int64 pool = BenchmarkCasts(Effect::operator new, Effect::operator delete);
+	unsigned __int64 heap = BenchmarkCasts(HeapAlloc, HeapRelease);
+	Log(DEBUG, "Effect", "%d casts of %d effects: pool %.3f ms, heap %.3f ms",
+		BENCHMARK_CASTS, BENCHMARK_EFFECTS_PER_CAST, pool / 1000.0, heap / 1000.0);
+}
+#endif
+
+void* Effect::operator new(size_t size)
+{
+	if (size != sizeof(Effect)) {
+		return ::operator new(size);
+	}
+
+#ifdef BENCHMARK_EFFECTS
+	static bool benchmarked = false;
+	if (!benchmarked) {
+		benchmarked = true;
+		BenchmarkEffectPool();
+	}
+#endif
+
+	MutexLock l(effectPoolLock);
+	if (!freeEffects) {
+		FreeEffect* slab = static_cast<FreeEffect*>(::operator new(EFFECT_SLAB_SIZE * sizeof(FreeEffect)));
+		for (int i = 0; i < EFFECT_SLAB_SIZE - 1; i++) {
+			slab[i].next = &slab[i + 1];
+		}
+		slab[EFFECT_SLAB_SIZE - 1].next = NULL;
+		freeEffects = slab;
+	}
+	FreeEffect* fx = freeEffects;
+	freeEffects = fx->next;
+	return fx;
+}
+
+void Effect::operator delete(void* ptr, size_t size)
+{
+	if (!ptr) {
+		return;
+	}
+	if (size != sizeof(Effect)) {
+		::operator delete(ptr);
+		return;
+	}
+
+	MutexLock l(effectPoolLock);
+	FreeEffect* fx = static_cast<FreeEffect*>(ptr);
+	fx->next = freeEffects;
+	freeEffects = fx;
+}
+
+}
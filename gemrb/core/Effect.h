@@ -27,10 +27,13 @@
 #ifndef EFFECT_H
 #define EFFECT_H
 
+#include "exports.h"
 #include "ie_types.h"
 
 #include "Region.h"
 
+#include <cstddef>
+
 namespace GemRB {
 
 class Actor;
@@ -80,10 +83,12 @@ class Actor;
 /**
  * @class Effect
  * Structure holding information about single spell or spell-like effect.
+ * Single effects come from a pool of fixed size slabs, since spells and
+ * projectiles create and drop lots of them.
  */
 
 // the same as ITMFeature and SPLFeature
-struct Effect {
+struct GEM_EXPORT Effect {
 	ieDword Opcode;
 	ieDword Target;
 	ieDword Power;
@@ -134,6 +139,9 @@ struct Effect {
 
 	ieDword SpellLevel; // Power does not always contain the Source level, which is needed in iwd2; items will be left at 0
 public:
+	static void* operator new(size_t size);
+	static void operator delete(void* ptr, size_t size);
+
 	//don't modify position in case it was already set
 	void SetPosition(const Point &p) {
 		if(PosX==0xffffffff && PosY==0xffffffff) {
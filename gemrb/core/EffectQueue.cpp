@@ -508,13 +508,17 @@ void EffectQueue::ApplyAllEffects(Actor* target) const
 {
 	std::list< Effect* >::const_iterator f;
 	for ( f = effects.begin(); f != effects.end(); f++ ) {
-		if (Opcodes[(*f)->Opcode].Flags & EFFECT_REINIT_ON_LOAD) {
-			// pretend to be the first application (FirstApply==1)
-			ApplyEffect(target, *f, 1);
-		} else {
-			ApplyEffect(target, *f, 0);
-		}
+		ReapplyEffect(target, *f);
+	}
+}
+
+int EffectQueue::ReapplyEffect(Actor* target, Effect* fx) const
+{
+	if (fx->Opcode < MAX_EFFECTS && (Opcodes[fx->Opcode].Flags & EFFECT_REINIT_ON_LOAD)) {
+		// pretend to be the first application (FirstApply==1)
+		return ApplyEffect(target, fx, 1);
 	}
+	return ApplyEffect(target, fx, 0);
 }
 
 void EffectQueue::Cleanup()
@@ -2076,6 +2080,29 @@ const Effect *EffectQueue::GetNextSavedEffect(std::list< Effect* >::const_iterat
 	return NULL;
 }
 
+bool EffectQueue::IsStatLocal(const Effect *fx) const
+{
+	if (fx->Opcode >= MAX_EFFECTS || fx->FirstApply) {
+		return false;
+	}
+	if ((Opcodes[fx->Opcode].Flags & (EFFECT_STAT_LOCAL|EFFECT_REINIT_ON_LOAD)) != EFFECT_STAT_LOCAL) {
+		return false;
+	}
+	// permanent stat changes end up in the base stats
+	if (fx->TimingMode == FX_DURATION_INSTANT_PERMANENT) {
+		return false;
+	}
+	// due effects have to go through ApplyEffect to trigger or expire
+	switch (DelayType(fx->TimingMode&0xff)) {
+	case PERMANENT:
+		return true;
+	case DURATION:
+		return fx->Duration > core->GetGame()->GameTime;
+	default:
+		return false;
+	}
+}
+
 Effect *EffectQueue::GetNextEffect(std::list< Effect* >::const_iterator &f) const
 {
 	if( f!=effects.end()) return *f++;
@@ -167,7 +167,10 @@ enum EffectFlags {
 	EFFECT_NO_LEVEL_CHECK = 2,
 	EFFECT_NO_ACTOR = 4,
 	EFFECT_REINIT_ON_LOAD = 8,
-	EFFECT_PRESET_TARGET = 16
+	EFFECT_PRESET_TARGET = 16,
+	// only changes the target's stats with SetStat, based on its own
+	// parameters and the stats it changes (so its result can be reused)
+	EFFECT_STAT_LOCAL = 32
 };
 
 /** Initializes table of available spell Effects used by all the queues. */
@@ -218,6 +221,8 @@ public:
 
 	int AddAllEffects(Actor* target, const Point &dest) const;
 	void ApplyAllEffects(Actor* target) const;
+	/** applies an effect of the queue again, like ApplyAllEffects */
+	int ReapplyEffect(Actor* target, Effect* fx) const;
 	/** remove effects marked for removal */
 	void Cleanup();
 
@@ -311,6 +316,9 @@ public:
 	/** just checks if it is a particularly stupid effect that needs its target reset */
 	static bool OverrideTarget(Effect *fx);
 	bool HasHostileEffects() const;
+	/** returns true if fx is EFFECT_STAT_LOCAL and neither triggers nor
+	 * expires when applied now */
+	bool IsStatLocal(const Effect *fx) const;
 private:
 	/** counts effects of specific opcode, parameters and resource */
 	ieDword CountEffects(ieDword opcode, ieDword param1, ieDword param2, const char *ResRef) const;
@@ -434,7 +434,8 @@ void Button::OnMouseDown(unsigned short x, unsigned short y,
 		}
 		SetState( IE_GUI_BUTTON_PRESSED );
 		if (Flags & IE_GUI_BUTTON_SOUND) {
-			core->PlaySound( DS_BUTTON_PRESSED );
+			// a click heard after the press is just confusing
+			core->PlaySound( DS_BUTTON_PRESSED, GEM_SND_RELATIVE|GEM_SND_SKIP_LATE );
 		}
 		if ((Button & GEM_MB_DOUBLECLICK) && ButtonOnDoublePress) {
 			RunEventHandler( ButtonOnDoublePress );
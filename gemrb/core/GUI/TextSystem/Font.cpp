@@ -27,10 +27,13 @@
 #include "Palette.h"
 #include "Video.h"
 
+#include <algorithm>
 #include <cwctype>
 
 namespace GemRB {
 
+size_t Font::printCacheLimit = 512 * 1024;
+
 static void BlitGlyphToCanvas(const Glyph& glyph, const Point& p,
 							  ieByte* canvas, const Size& size)
 {
@@ -39,13 +42,12 @@ static void BlitGlyphToCanvas(const Glyph& glyph, const Point& p,
 		return; // need both a src and dst
 	}
 
-	// find the origin and clip to it.
-	// only worry about origin < 0.
+	// find the origin and clip to the canvas
 	Point blitPoint = p + glyph.pos;
 	Size srcSize = glyph.size;
 	if (blitPoint.y < 0) {
-		int offset = (-blitPoint.y * glyph.size.w);
-		src += offset;
+		int offset = -blitPoint.y;
+		src += offset * glyph.pitch;
 		srcSize.h -= offset;
 		blitPoint.y = 0;
 	}
@@ -55,20 +57,36 @@ static void BlitGlyphToCanvas(const Glyph& glyph, const Point& p,
 		srcSize.w -= offset;
 		blitPoint.x = 0;
 	}
+	if (blitPoint.x + srcSize.w > size.w) {
+		srcSize.w = size.w - blitPoint.x;
+	}
+	if (blitPoint.y + srcSize.h > size.h) {
+		srcSize.h = size.h - blitPoint.y;
+	}
+	if (srcSize.w <= 0 || srcSize.h <= 0) {
+		return;
+	}
 	ieByte* dest = canvas + (size.w * blitPoint.y) + blitPoint.x;
 	assert(src >= glyph.pixels);
 	assert(dest >= canvas);
 	// copy the glyph to the canvas
 	for(int row = 0; row < srcSize.h; row++ ) {
-		if (dest + srcSize.w > canvas + (size.w * size.h)) {
-			break;
-		}
 		memcpy(dest, src, srcSize.w);
 		dest += size.w;
 		src += glyph.pitch;
 	}
 }
 
+bool Font::PrintKey::operator<(const PrintKey& other) const
+{
+	if (size.w != other.size.w) return size.w < other.size.w;
+	if (size.h != other.size.h) return size.h < other.size.h;
+	if (point.x != other.point.x) return point.x < other.point.x;
+	if (point.y != other.point.y) return point.y < other.point.y;
+	if (alignment != other.alignment) return alignment < other.alignment;
+	return text < other.text;
+}
+
 
 bool Font::GlyphAtlasPage::AddGlyph(ieWord chr, const Glyph& g)
 {
@@ -154,11 +172,14 @@ Font::Font(Palette* pal, ieWord lineheight, ieWord baseline)
 : palette(NULL), LineHeight(lineheight), Baseline(baseline)
 {
 	CurrentAtlasPage = NULL;
+	glyphAbove = glyphBelow = 0;
+	printCacheSize = 0;
 	SetPalette(pal);
 }
 
 Font::~Font(void)
 {
+	ClearPrintCache();
 	GlyphAtlas::iterator it;
 	for (it = Atlas.begin(); it != Atlas.end(); ++it) {
 		delete *it;
@@ -188,6 +209,8 @@ const Glyph& Font::CreateGlyphForCharSprite(ieWord chr, const Sprite2D* spr)
 	Point pos(0, Baseline - spr->YPos);
 
 	Glyph tmp = Glyph(size, pos, (ieByte*)spr->pixels, spr->Width);
+	glyphAbove = std::max(glyphAbove, -pos.y);
+	glyphBelow = std::max(glyphBelow, pos.y + size.h - LineHeight);
 	// adjust the location for the glyph
 	if (!CurrentAtlasPage || !CurrentAtlasPage->AddGlyph(chr, tmp)) {
 		// page is full, make a new one
@@ -228,7 +251,8 @@ const Glyph& Font::GetGlyph(ieWord chr) const
 
 size_t Font::RenderText(const String& string, Region& rgn,
 						Palette* color, ieByte alignment,
-						Point* point, ieByte** canvas, bool grow) const
+						Point* point, ieByte** canvas, bool grow,
+						const Size* canvasSize) const
 {
 	// NOTE: vertical alignment is not handled here.
 	// it should have been calculated previously and passed in via the "point" parameter
@@ -256,7 +280,7 @@ size_t Font::RenderText(const String& string, Region& rgn,
 		}
 
 		// check if we need to extend the canvas
-		if (canvas && grow && rgn.h < dp.y) {
+		if (canvas && grow && !canvasSize && rgn.h < dp.y) {
 			size_t pos = (stringPos < string.length()) ? stringPos : string.length() - 1;
 			pos -= line.length();
 			Size textSize = StringSize(string.substr(pos));
@@ -292,7 +316,7 @@ size_t Font::RenderText(const String& string, Region& rgn,
 			// check to see if the line is on screen
 			// TODO: technically we could be *even more* optimized by passing lineRgn, but this breaks dropcaps
 			// this isn't a big deal ATM, because the big text containers do line-by-line layout
-			if (!sclip.IntersectsRegion(rgn)) {
+			if (!canvas && !sclip.IntersectsRegion(rgn)) {
 				// offscreen, optimize by bypassing RenderLine, we pre-calculated linePos above
 				// alignment is completely irrelevant here since the width is the same for all alignments
 				linePoint.x = lineSize.w;
@@ -330,7 +354,8 @@ size_t Font::RenderText(const String& string, Region& rgn,
 				core->GetVideoDriver()->DrawRect(Region(linePoint + lineRgn.Origin(),
 												 Size(lineSize.w, LineHeight)), ColorWhite, false);
 #endif
-				linePos = RenderLine(line, lineRgn, color, linePoint, canvas);
+				linePos = RenderLine(line, lineRgn, color, linePoint, canvas,
+									 (canvasSize) ? *canvasSize : rgn.Dimensions());
 			}
 			if (linePos == 0) {
 				break; // if linePos == 0 then we would loop till we are out of bounds so just stop here
@@ -360,7 +385,7 @@ size_t Font::RenderText(const String& string, Region& rgn,
 	}
 
 	// free the unused canvas area (if any)
-	if (canvas) {
+	if (canvas && !canvasSize) {
 		int usedh = dp.y;
 		if (usedh < rgn.h) {
 			// this is more than just saving memory
@@ -383,7 +408,7 @@ size_t Font::RenderText(const String& string, Region& rgn,
 }
 
 size_t Font::RenderLine(const String& line, const Region& lineRgn,
-						Palette* color, Point& dp, ieByte** canvas) const
+						Palette* color, Point& dp, ieByte** canvas, const Size& canvasSize) const
 {
 	assert(color); // must have a palette
 	assert(lineRgn.h == LineHeight);
@@ -447,7 +472,8 @@ size_t Font::RenderLine(const String& line, const Region& lineRgn,
 			}
 
 			if (canvas) {
-				BlitGlyphToCanvas(curGlyph, blitPoint, *canvas, lineRgn.Dimensions());
+				// the canvas adds the glyph position itself
+				BlitGlyphToCanvas(curGlyph, dp + lineRgn.Origin(), *canvas, canvasSize);
 			} else {
 				size_t pageIdx = AtlasIndex[currChar].pageIdx;
 				GlyphAtlasPage* page = Atlas[pageIdx];
@@ -576,6 +602,21 @@ size_t Font::Print(Region rgn, const String& string,
 		}
 	}
 
+	PrintedText text;
+	if (printCacheLimit && string.length()
+		&& core->GetVideoDriver()->GetScreenClip().IntersectsRegion(rgn)
+		&& CachedPrint(rgn.Dimensions(), string, alignment, p, text)) {
+		if (text.sprite) {
+			Region src(Point(), Size(text.sprite->Width, text.sprite->Height));
+			Region dst(rgn.Origin() + text.pos, src.Dimensions());
+			core->GetVideoDriver()->BlitSprite(text.sprite, src, dst, pal);
+		}
+		if (point) {
+			*point = text.endPoint;
+		}
+		return text.numPrinted;
+	}
+
 	size_t ret = RenderText(string, rgn, pal, alignment, &p);
 	if (point) {
 		*point = p;
@@ -583,6 +624,98 @@ size_t Font::Print(Region rgn, const String& string,
 	return ret;
 }
 
+bool Font::CachedPrint(const Size& size, const String& string,
+					   ieByte alignment, const Point& p, PrintedText& text) const
+{
+	PrintKey key;
+	key.text = string;
+	key.size = size;
+	key.point = p;
+	key.alignment = alignment;
+
+	PrintCacheIndex::iterator it = printCacheIndex.find(key);
+	if (it != printCacheIndex.end()) {
+		printCache.splice(printCache.begin(), printCache, it->second);
+		text = it->second->second;
+		return true;
+	}
+
+	// make sure any new glyphs (TTF) are accounted for in the overhang
+	for (size_t i = 0; i < string.length(); i++) {
+		GetGlyph(string[i]);
+	}
+	// leave room for the lines above the region (negative p.y),
+	// the last line reaching below it and glyphs sticking out of their line
+	int top = glyphAbove + std::max(0, -p.y);
+	Size canvasSize(size.w, top + size.h + LineHeight + glyphBelow);
+	if ((size_t) canvasSize.Area() > printCacheLimit / 4) {
+		return false;
+	}
+	ieByte* canvas = (ieByte*)calloc(canvasSize.w, canvasSize.h);
+	Region rgn(Point(0, top), size);
+	text.sprite = NULL;
+	text.endPoint = p;
+	text.numPrinted = RenderText(string, rgn, palette, alignment, &text.endPoint, &canvas, false, &canvasSize);
+
+	// crop to the printed pixels
+	int x1 = canvasSize.w, y1 = canvasSize.h, x2 = -1, y2 = -1;
+	for (int y = 0; y < canvasSize.h; y++) {
+		const ieByte* row = canvas + y * canvasSize.w;
+		for (int x = 0; x < canvasSize.w; x++) {
+			if (row[x]) {
+				x1 = std::min(x1, x);
+				x2 = std::max(x2, x);
+				y1 = std::min(y1, y);
+				y2 = y;
+			}
+		}
+	}
+	text.size = sizeof(PrintKey) + sizeof(PrintedText) + string.length() * sizeof(wchar_t);
+	if (x2 >= 0) {
+		Size cropSize(x2 - x1 + 1, y2 - y1 + 1);
+		ieByte* pixels = (ieByte*)malloc(cropSize.Area());
+		for (int y = 0; y < cropSize.h; y++) {
+			memcpy(pixels + y * cropSize.w, canvas + (y1 + y) * canvasSize.w + x1, cropSize.w);
+		}
+		text.sprite = core->GetVideoDriver()->CreateSprite8(cropSize.w, cropSize.h, pixels, palette, true, 0);
+		text.pos = Point(x1, y1 - top);
+		text.size += cropSize.Area();
+	}
+	free(canvas);
+
+	printCache.push_front(std::make_pair(key, text));
+	printCacheIndex[key] = printCache.begin();
+	printCacheSize += text.size;
+	while (printCacheSize > printCacheLimit && printCache.size() > 1) {
+		PrintedText& old = printCache.back().second;
+		if (old.sprite) {
+			Sprite2D::FreeSprite(old.sprite);
+		}
+		printCacheSize -= old.size;
+		printCacheIndex.erase(printCache.back().first);
+		printCache.pop_back();
+	}
+	return true;
+}
+
+void Font::ClearPrintCache() const
+{
+	PrintCache::iterator it = printCache.begin();
+	for (; it != printCache.end(); ++it) {
+		if (it->second.sprite) {
+			Sprite2D::FreeSprite(it->second.sprite);
+		}
+	}
+	printCache.clear();
+	printCacheIndex.clear();
+	printCacheSize = 0;
+}
+
+void Font::SetPrintCacheSize(int kb)
+{
+	printCacheLimit = (kb > 0) ? kb * 1024 : 0;
+}
+
 Size Font::StringSize(const String& string, StringSizeMetrics* metrics) const
 {
 	if (!string.length()) return Size();
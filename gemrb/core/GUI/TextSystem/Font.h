@@ -38,6 +38,7 @@
 #include "Sprite2D.h"
 
 #include <deque>
+#include <list>
 #include <map>
 
 namespace GemRB {
@@ -150,6 +151,36 @@ private:
 	GlyphAtlasPage* CurrentAtlasPage;
 	GlyphIndex AtlasIndex;
 	GlyphAtlas Atlas;
+	// how far glyphs reach out of their line
+	int glyphAbove, glyphBelow;
+
+	/*
+	 Print() renders each string once into an 8 bit sprite and blits that on later calls.
+	 The sprites only hold glyph indexes, the palette is applied when blitting,
+	 so a palette change doesn't invalidate them.
+	 */
+	struct PrintKey {
+		String text;
+		Size size;
+		Point point;
+		ieByte alignment;
+
+		bool operator<(const PrintKey&) const;
+	};
+	struct PrintedText {
+		Sprite2D* sprite; // NULL if nothing visible was printed
+		Point pos; // sprite position in the print region
+		size_t numPrinted;
+		Point endPoint;
+		size_t size; // bytes accounted for the cache budget
+	};
+	typedef std::list<std::pair<PrintKey, PrintedText> > PrintCache;
+	typedef std::map<PrintKey, PrintCache::iterator> PrintCacheIndex;
+	// most recently used first
+	mutable PrintCache printCache;
+	mutable PrintCacheIndex printCacheIndex;
+	mutable size_t printCacheSize;
+	static size_t printCacheLimit;
 
 protected:
 	Palette* palette;
@@ -161,11 +192,16 @@ public:
 private:
 	void CreateGlyphIndex(ieWord chr, ieWord pageIdx, const Glyph*);
 	// Blit to the sprite or screen if canvas is NULL
+	// canvasSize is the size of a canvas larger than the region, it can't grow
 	size_t RenderText(const String&, Region&, Palette*, ieByte alignment,
-					  Point* = NULL, ieByte** canvas = NULL, bool grow = false) const;
+					  Point* = NULL, ieByte** canvas = NULL, bool grow = false,
+					  const Size* canvasSize = NULL) const;
 	// render a single line of text. called by RenderText()
 	size_t RenderLine(const String& string, const Region& rgn, Palette* hicolor,
-					  Point& dp, ieByte** canvas = NULL) const;
+					  Point& dp, ieByte** canvas = NULL, const Size& canvasSize = Size()) const;
+	// returns false if the text is too large to cache
+	bool CachedPrint(const Size&, const String&, ieByte alignment, const Point&, PrintedText&) const;
+	void ClearPrintCache() const;
 
 public:
 	Font(Palette*, ieWord lineheight, ieWord baseline);
@@ -182,6 +218,9 @@ public:
 	Palette* GetPalette() const;
 	void SetPalette(Palette* pal);
 
+	/** Sets how many KiB of sprites each font keeps for Print(), 0 disables it */
+	static void SetPrintCacheSize(int kb);
+
 	int KerningOffset(ieWord /*leftChr*/, ieWord /*rightChr*/) const {return 0;};
 
 	Sprite2D* RenderTextAsSprite(const String& string, const Size& size, ieByte alignment,
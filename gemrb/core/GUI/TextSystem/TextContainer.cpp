@@ -406,18 +406,41 @@ Region ContentContainer::BoundingBoxForContent(const Content* c) const
 
 const ContentContainer::Layout& ContentContainer::LayoutForContent(const Content* c) const
 {
-	ContentLayout::const_iterator it = std::find(layout.begin(), layout.end(), c);
-	if (it != layout.end()) {
+	// search from the end, we mostly look for the content laid out last
+	ContentLayout::const_reverse_iterator it = std::find(layout.rbegin(), layout.rend(), c);
+	if (it != layout.rend()) {
 		return *it;
 	}
 	static Layout NullLayout(NULL, Regions());
 	return NullLayout;
 }
 
+void ContentContainer::AddLayout(const Content* content, const Regions& rgns)
+{
+	layout.push_back(Layout(content, rgns));
+	Layout& l = layout.back();
+	l.top = INT_MAX;
+	l.bottom = INT_MIN;
+	Regions::const_iterator rit = rgns.begin();
+	for (; rit != rgns.end(); ++rit) {
+		l.top = std::min(l.top, (*rit).y);
+		l.bottom = std::max(l.bottom, (*rit).y + (*rit).h);
+	}
+	if (layout.size() > 1) {
+		l.bottom = std::max(l.bottom, layout[layout.size() - 2].bottom);
+	}
+}
+
+ContentContainer::ContentLayout::const_iterator ContentContainer::FirstLayoutBelow(int y) const
+{
+	// the bottoms never decrease, so nothing before this can reach y
+	return std::upper_bound(layout.begin(), layout.end(), y, Layout::EndsBelow);
+}
+
 const Region* ContentContainer::ContentRegionForRect(const Region& r) const
 {
-	ContentLayout::const_iterator it = layout.begin();
-	for (; it != layout.end(); ++it) {
+	ContentLayout::const_iterator it = FirstLayoutBelow(r.y);
+	for (; it != layout.end() && (*it).top < r.y + r.h; ++it) {
 		const Regions& rgns = (*it).regions;
 		Regions::const_iterator rit = rgns.begin();
 		for (; rit != rgns.end(); ++rit) {
@@ -470,13 +493,16 @@ void ContentContainer::LayoutContentsFrom(ContentList::const_iterator it)
 		it++;
 	}
 	// clear the existing layout, but only for "it" and onward
-	ContentList::const_iterator clearit = it;
-	for (; clearit != contents.end(); ++clearit) {
-		ContentLayout::iterator i = std::find(layout.begin(), layout.end(), *clearit);
-		if (i != layout.end()) {
-			layoutPoint = Point(); // reset cached layoutPoint
-			layout.erase(i);
-		}
+	// the layout is in content order, so that is everything after exContent
+	ContentLayout::iterator clearit = layout.begin();
+	if (exContent) {
+		ContentLayout::reverse_iterator i = std::find(layout.rbegin(), layout.rend(), exContent);
+		assert(i != layout.rend());
+		clearit = i.base();
+	}
+	if (clearit != layout.end()) {
+		layoutPoint = Point(); // reset cached layoutPoint
+		layout.erase(clearit, layout.end());
 	}
 
 	while (it != contents.end()) {
@@ -503,7 +529,7 @@ void ContentContainer::LayoutContentsFrom(ContentList::const_iterator it)
 			assert(exContent != content);
 		}
 		const Regions& rgns = content->LayoutForPointInRegion(layoutPoint, frame);
-		layout.push_back(Layout(content, rgns));
+		AddLayout(content, rgns);
 		const Region& bounds = Region::RegionEnclosingRegions(rgns);
 		contentBounds.h = (bounds.y + bounds.h > contentBounds.h) ? bounds.y + bounds.h : contentBounds.h;
 		contentBounds.w = (bounds.x + bounds.w > contentBounds.w) ? bounds.x + bounds.w : contentBounds.w;
@@ -523,11 +549,14 @@ void ContentContainer::DrawContentsInRegions(const Regions& rgns, const Point& o
 	// should only have 1 region
 	const Region& rgn = rgns.front();
 
-	// TODO: intersect with the screen clip so we can bail out even earlier
-
 	const Point& drawOrigin = rgn.Origin();
 	Point drawPoint = drawOrigin;
-	ContentLayout::const_iterator it = layout.begin();
+	// only draw the content inside the screen clip
+	Point drawOffset = offset + parentOffset;
+	Region clip = core->GetVideoDriver()->GetScreenClip();
+	clip.x -= drawOffset.x;
+	clip.y -= drawOffset.y;
+	ContentLayout::const_iterator it = FirstLayoutBelow(clip.y);
 
 #if (DEBUG_TEXT)
 	Region dr(parentOffset + offset, contentBounds);
@@ -538,30 +567,80 @@ void ContentContainer::DrawContentsInRegions(const Regions& rgns, const Point& o
 	core->GetVideoDriver()->DrawRect(dr, ColorWhite, false);
 #endif
 
-	for (; it != layout.end(); ++it) {
+	for (; it != layout.end() && (*it).top < clip.y + clip.h; ++it) {
 		const Layout& l = *it;
+		Regions::const_iterator rit = l.regions.begin();
+		for (; rit != l.regions.end(); ++rit) {
+			if ((*rit).IntersectsRegion(clip)) break;
+		}
+		if (rit == l.regions.end()) continue;
+
 		assert(drawPoint.x <= drawOrigin.x + frame.w);
-		l.content->DrawContentsInRegions(l.regions, offset + parentOffset);
+		l.content->DrawContentsInRegions(l.regions, drawOffset);
 	}
 }
 
 void ContentContainer::DeleteContentsInRect(Region exclusion)
 {
-	int top = exclusion.y;
-	int bottom = top;
+	int bottom = exclusion.y + exclusion.h;
+	Point oldLayoutPoint = layoutPoint;
+	bool deleted = false;
 	const Content* content;
 	while (const Region* rgn = ContentRegionForRect(exclusion)) {
 		content = ContentAtPoint(rgn->Origin());
 		assert(content);
 
-		top = (rgn->y < top) ? rgn->y : top;
-		bottom = (rgn->y + rgn->h > bottom) ? rgn->y + rgn->h : bottom;
+		// take the whole lines of the content, so the rest doesn't move sideways
+		const Region& bounds = BoundingBoxForContent(content);
+		if (bounds.y + bounds.h > bottom) {
+			bottom = bounds.y + bounds.h;
+			exclusion.h = bottom - exclusion.y;
+		}
 		// must delete content last!
 		delete RemoveContent(content, false);
+		deleted = true;
 	}
+	if (!deleted) {
+		return;
+	}
+
+	if (!layout.empty() && layout.front().top >= bottom
+		&& layout.front().regions.front().x == frame.x) {
+		// the content left was all below what we deleted and starts a line,
+		// laying it out again would only move it up
+		layoutPoint = oldLayoutPoint;
+		ShiftLayoutUp(layout.front().top - frame.y);
+	} else {
+		LayoutContentsFrom(contents.begin());
+	}
+}
 
-	// TODO: we could optimize this to only layout content after exclusion.y
-	LayoutContentsFrom(contents.begin());
+void ContentContainer::ShiftLayoutUp(int dy)
+{
+	contentBounds = Size();
+	ContentLayout::iterator it = layout.begin();
+	for (; it != layout.end(); ++it) {
+		Layout& l = *it;
+		l.top -= dy;
+		l.bottom -= dy;
+		Regions::iterator rit = l.regions.begin();
+		for (; rit != l.regions.end(); ++rit) {
+			(*rit).y -= dy;
+		}
+		const Region& bounds = Region::RegionEnclosingRegions(l.regions);
+		contentBounds.h = (bounds.y + bounds.h > contentBounds.h) ? bounds.y + bounds.h : contentBounds.h;
+		contentBounds.w = (bounds.x + bounds.w > contentBounds.w) ? bounds.x + bounds.w : contentBounds.w;
+	}
+	if (layoutPoint.y > dy) {
+		layoutPoint.y -= dy;
+	} else {
+		layoutPoint = Point(); // reset cached layoutPoint
+	}
+
+	if (parent) {
+		// the parent needs to update to compensate for changes in this container
+		parent->LayoutContentsFrom(this);
+	}
 }
 
 
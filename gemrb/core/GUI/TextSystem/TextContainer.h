@@ -114,9 +114,12 @@ protected:
 	struct Layout {
 		const Content* content;
 		Regions regions;
+		// layouts are ordered by top, bottom is the lowest edge
+		// of this and all the preceding layouts
+		int top, bottom;
 
 		Layout(const Content* c, const Regions r)
-		: content(c), regions(r) {}
+		: content(c), regions(r), top(0), bottom(0) {}
 
 		bool operator==(const Content* c) const {
 			return c == content;
@@ -136,6 +139,10 @@ protected:
 			}
 			return false;
 		}
+
+		static bool EndsBelow(int y, const Layout& l) {
+			return y < l.bottom;
+		}
 	};
 
 	typedef std::deque<Layout> ContentLayout;
@@ -153,6 +160,7 @@ public:
 	// removes the span from the container and transfers ownership to the caller.
 	// Returns a non-const pointer to the removed span.
 	Content* RemoveContent(const Content* content);
+	// removes the content in the rect and anything sharing lines with it
 	virtual void DeleteContentsInRect(Region);
 
 	Content* ContentAtPoint(const Point& p) const;
@@ -171,6 +179,10 @@ protected:
 	void LayoutContentsFrom(const Content*);
 	Content* RemoveContent(const Content* content, bool doLayout);
 	const Layout& LayoutForContent(const Content*) const;
+	void AddLayout(const Content*, const Regions&);
+	// returns the first layout that may reach below y
+	ContentLayout::const_iterator FirstLayoutBelow(int y) const;
+	void ShiftLayoutUp(int dy);
 };
 
 // TextContainers can hold any content, but they represent a string of text that is divided into TextSpans
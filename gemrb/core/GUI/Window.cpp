@@ -110,6 +110,7 @@ void Window::DrawWindow()
 			video->BlitSprite( core->WindowFrames[2], (core->Width - core->WindowFrames[2]->Width) / 2, 0, true );
 		if (core->WindowFrames[3])
 			video->BlitSprite( core->WindowFrames[3], (core->Width - core->WindowFrames[3]->Width) / 2, core->Height - core->WindowFrames[3]->Height, true );
+		video->InvalidateScreen();
 	}
 
 	video->SetScreenClip( &clip );
@@ -118,6 +119,7 @@ void Window::DrawWindow()
 	if (BackGround && (Flags & (WF_FLOAT|WF_CHANGED) ) ) {
 		DrawBackground(NULL);
 		bgRefreshed = true;
+		video->InvalidateRegion(clip);
 	}
 
 	std::vector< Control*>::iterator m;
@@ -139,6 +141,7 @@ void Window::DrawWindow()
 	if ( (Flags&WF_CHANGED) && (Visible == WINDOW_GRAYED) ) {
 		Color black = { 0, 0, 0, 128 };
 		video->DrawRect(clip, black);
+		video->InvalidateRegion(clip);
 	}
 	video->SetScreenClip( NULL );
 	Flags &= ~WF_CHANGED;
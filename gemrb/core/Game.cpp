@@ -270,6 +270,12 @@ Actor* Game::FindPC(unsigned int partyID)
 
 Actor* Game::FindPC(const char *scriptingname)
 {
+	Actor *actor;
+	size_t count = pcNames.Find(scriptingname, actor);
+	if (count < 2) {
+		return actor;
+	}
+	// the first one in party order wins
 	for (unsigned int slot=0; slot<PCs.size(); slot++) {
 		if (strnicmp(PCs[slot]->GetScriptName(),scriptingname,32)==0 ) {
 			return PCs[slot];
@@ -288,6 +294,11 @@ Actor* Game::FindNPC(unsigned int partyID)
 
 Actor* Game::FindNPC(const char *scriptingname)
 {
+	Actor *actor;
+	size_t count = npcNames.Find(scriptingname, actor);
+	if (count < 2) {
+		return actor;
+	}
 	for (unsigned int slot=0; slot<NPCs.size(); slot++) {
 		if (strnicmp(NPCs[slot]->GetScriptName(),scriptingname,32)==0 )
 		{
@@ -299,19 +310,11 @@ Actor* Game::FindNPC(const char *scriptingname)
 
 Actor *Game::GetGlobalActorByGlobalID(ieDword globalID)
 {
-	unsigned int slot;
-
-	for (slot=0; slot<PCs.size(); slot++) {
-		if (PCs[slot]->GetGlobalID()==globalID ) {
-			return PCs[slot];
-		}
-	}
-	for (slot=0; slot<NPCs.size(); slot++) {
-		if (NPCs[slot]->GetGlobalID()==globalID ) {
-			return NPCs[slot];
-		}
+	std::map<ieDword, Actor*>::const_iterator it = actorsByID.find(globalID);
+	if (it == actorsByID.end()) {
+		return NULL;
 	}
-	return NULL;
+	return it->second;
 }
 
 Actor* Game::GetPC(unsigned int slot, bool onlyalive)
@@ -364,6 +367,8 @@ int Game::DelPC(unsigned int slot, bool autoFree)
 		return -1;
 	}
 	SelectActor(PCs[slot], false, SELECT_NORMAL);
+	pcNames.Remove(PCs[slot]);
+	actorsByID.erase(PCs[slot]->GetGlobalID());
 	if (autoFree) {
 		delete( PCs[slot] );
 	}
@@ -380,6 +385,8 @@ int Game::DelNPC(unsigned int slot, bool autoFree)
 	if (!NPCs[slot]) {
 		return -1;
 	}
+	npcNames.Remove(NPCs[slot]);
+	actorsByID.erase(NPCs[slot]->GetGlobalID());
 	if (autoFree) {
 		delete( NPCs[slot] );
 	}
@@ -423,6 +430,7 @@ int Game::LeaveParty (Actor* actor)
 	}
 	std::vector< Actor*>::iterator m = PCs.begin() + slot;
 	PCs.erase( m );
+	pcNames.Remove(actor);
 
 	ieDword id = actor->GetGlobalID();
 	for ( m = PCs.begin(); m != PCs.end(); ++m) {
@@ -434,6 +442,7 @@ int Game::LeaveParty (Actor* actor)
 	//removing from party, but actor remains in 'game'
 	actor->SetPersistent(0);
 	NPCs.push_back( actor );
+	npcNames.Add(actor);
 
 	if (core->HasFeature( GF_HAS_DPLAYER )) {
 		// we must reset various existing scripts
@@ -547,9 +556,12 @@ int Game::JoinParty(Actor* actor, int join)
 	if (slot >= 0) {
 		std::vector< Actor*>::iterator m = NPCs.begin() + slot;
 		NPCs.erase( m );
+		npcNames.Remove(actor);
 	}
 
 	PCs.push_back( actor );
+	pcNames.Add(actor);
+	actorsByID[actor->GetGlobalID()] = actor;
 	if (!actor->InParty) {
 		actor->InParty = (ieByte) (size+1);
 	}
@@ -1025,6 +1037,8 @@ int Game::AddNPC(Actor* npc)
 	} //can't add as npc already in party
 	npc->SetPersistent(0);
 	NPCs.push_back( npc );
+	npcNames.Add(npc);
+	actorsByID[npc->GetGlobalID()] = npc;
 
 	return (int) NPCs.size() - 1;
 }
@@ -35,8 +35,10 @@
 #include "Callback.h"
 #include "Scriptable/Scriptable.h"
 #include "Scriptable/PCStatStruct.h"
+#include "Scriptable/ScriptNameIndex.h"
 #include "Variables.h"
 
+#include <map>
 #include <vector>
 
 namespace GemRB {
@@ -248,6 +250,10 @@ public:
 private:
 	std::vector< Actor*> PCs;
 	std::vector< Actor*> NPCs;
+	// lookup indexes for the two lists above
+	ScriptNameIndex<Actor> pcNames;
+	ScriptNameIndex<Actor> npcNames;
+	std::map<ieDword, Actor*> actorsByID;
 	std::vector< Map*> Maps;
 	std::vector< GAMJournalEntry*> Journals;
 	std::vector< GAMLocationEntry*> savedpositions;
@@ -45,6 +45,7 @@
 #include "Scriptable/Actor.h"
 #include "System/FileStream.h"
 
+#include <cctype>
 #include <cstdio>
 
 namespace GemRB {
@@ -156,6 +157,15 @@ int GameData::LoadCreature(const char* ResRef, unsigned int PartySlot, bool char
 	}
 }
 
+static std::string TableKey(const char* ResRef)
+{
+	std::string key;
+	for (int i = 0; i < 8 && ResRef[i]; i++) {
+		key += (char) tolower((unsigned char) ResRef[i]);
+	}
+	return key;
+}
+
 /** Loads a 2DA Table, returns -1 on error or the Table Index on success */
 int GameData::LoadTable(const ieResRef ResRef, bool silent)
 {
@@ -188,23 +198,23 @@ int GameData::LoadTable(const ieResRef ResRef, bool silent)
 			break;
 		}
 	}
-	if (ind != -1) {
+	if (ind == -1) {
+		ind = ( int ) tables.size();
+		tables.push_back( t );
+	} else {
 		tables[ind] = t;
-		return ind;
 	}
-	tables.push_back( t );
-	return ( int ) tables.size() - 1;
+	tableIndex[TableKey(ResRef)] = ind;
+	return ind;
 }
 /** Gets the index of a loaded table, returns -1 on error */
 int GameData::GetTableIndex(const char* ResRef) const
 {
-	for (size_t i = 0; i < tables.size(); i++) {
-		if (tables[i].refcount == 0)
-			continue;
-		if (strnicmp( tables[i].ResRef, ResRef, 8 ) == 0)
-			return ( int ) i;
+	std::map<std::string, int>::const_iterator it = tableIndex.find(TableKey(ResRef));
+	if (it == tableIndex.end()) {
+		return -1;
 	}
-	return -1;
+	return it->second;
 }
 /** Gets a Loaded Table by its index, returns NULL on error */
 Holder<TableMgr> GameData::GetTable(unsigned int index) const
@@ -223,6 +233,7 @@ bool GameData::DelTable(unsigned int index)
 {
 	if (index==0xffffffff) {
 		tables.clear();
+		tableIndex.clear();
 		return true;
 	}
 	if (index >= tables.size()) {
@@ -232,9 +243,11 @@ bool GameData::DelTable(unsigned int index)
 		return false;
 	}
 	tables[index].refcount--;
-	if (tables[index].refcount == 0)
+	if (tables[index].refcount == 0) {
+		tableIndex.erase(TableKey(tables[index].ResRef));
 		if (tables[index].tm)
 			tables[index].tm.release();
+	}
 	return true;
 }
 
@@ -31,6 +31,7 @@
 #include "ResourceManager.h"
 
 #include <map>
+#include <string>
 #include <vector>
 
 #ifdef _MSC_VER // No SFINAE
@@ -118,6 +119,8 @@ private:
 	Cache PaletteCache;
 	Factory* factory;
 	std::vector<Table> tables;
+	// loaded tables by their lowercased resref
+	std::map<std::string, int> tableIndex;
 	typedef std::map<const char*, Store*, iless> StoreMap;
 	StoreMap stores;
 };
@@ -4167,6 +4167,7 @@ void GameScript::XEquipItem(Scriptable *Sender, Action* parameters)
 	int slot2 = parameters->int0Parameter;
 	bool equip = parameters->int1Parameter;
 
+	actor->inventory.BeginEquipChanges();
 	if (equip) {
 		if (slot != slot2) {
 			// swap them first, so we equip to the desired slot
@@ -4191,6 +4192,7 @@ void GameScript::XEquipItem(Scriptable *Sender, Action* parameters)
 			}
 		}
 	}
+	actor->inventory.CommitEquipChanges();
 
 	actor->ReinitQuickSlots();
 }
@@ -4244,6 +4246,7 @@ void GameScript::EquipItem(Scriptable *Sender, Action* parameters)
 		//equip item if possible
 		slot2 = SLOT_AUTOEQUIP;
 	}
+	actor->inventory.BeginEquipChanges();
 	CREItem *si = actor->inventory.RemoveItem(slot);
 	if (si) {
 		if (actor->inventory.AddSlotItem(si, slot2)==ASI_FAILED) {
@@ -4256,6 +4259,7 @@ void GameScript::EquipItem(Scriptable *Sender, Action* parameters)
 			}
 		}
 	}
+	actor->inventory.CommitEquipChanges();
 	actor->ReinitQuickSlots();
 }
 
@@ -1882,6 +1882,21 @@ Action *ParamCopyNoOverride(Action *parameters)
 	return newAction;
 }
 
+Trigger *TriggerCopy(Trigger *parameters)
+{
+	Trigger *newTrigger = new Trigger();
+	newTrigger->triggerID = parameters->triggerID;
+	newTrigger->flags = parameters->flags;
+	newTrigger->int0Parameter = parameters->int0Parameter;
+	newTrigger->int1Parameter = parameters->int1Parameter;
+	newTrigger->int2Parameter = parameters->int2Parameter;
+	newTrigger->pointParameter = parameters->pointParameter;
+	MEMCPY( newTrigger->string0Parameter, parameters->string0Parameter );
+	MEMCPY( newTrigger->string1Parameter, parameters->string1Parameter );
+	newTrigger->objectParameter = ObjectCopy( parameters->objectParameter );
+	return newTrigger;
+}
+
 Trigger *GenerateTriggerCore(const char *src, const char *str, int trIndex, int negate)
 {
 	Trigger *newTrigger = new Trigger();
@@ -33,6 +33,9 @@
 #include "RNG/RNG_SFMT.h"
 #include "System/StringBuffer.h"
 
+#include <map>
+#include <string>
+
 namespace GemRB {
 
 //debug flags
@@ -1332,9 +1335,33 @@ void Targets::dump() const
 	}
 }
 
+// parsed actions and triggers by their (lowercased) source, so dialogs and
+// other runtime callers don't have to parse the same strings over and over
+// the stored prototypes are never handed out, only copies of them
+typedef std::map<std::string, Action*> ActionCache;
+typedef std::map<std::string, Trigger*> TriggerCache;
+static ActionCache compiledActions;
+static TriggerCache compiledTriggers;
+#define MAX_COMPILED_CACHE 4096
+
+static void ClearCompiledCache()
+{
+	ActionCache::iterator a;
+	for (a = compiledActions.begin(); a != compiledActions.end(); ++a) {
+		a->second->Release();
+	}
+	compiledActions.clear();
+	TriggerCache::iterator t;
+	for (t = compiledTriggers.begin(); t != compiledTriggers.end(); ++t) {
+		t->second->Release();
+	}
+	compiledTriggers.clear();
+}
+
 /** releasing global memory */
 static void CleanupIEScript()
 {
+	ClearCompiledCache();
 	triggersTable.release();
 	actionsTable.release();
 	objectsTable.release();
@@ -2458,6 +2485,11 @@ Trigger* GenerateTrigger(char* String)
 	if (InDebug&ID_TRIGGERS) {
 		Log(WARNING, "GameScript", "Compiling:%s", String);
 	}
+	TriggerCache::const_iterator cached = compiledTriggers.find(String);
+	if (cached != compiledTriggers.end()) {
+		return TriggerCopy(cached->second);
+	}
+	std::string key = String;
 	int negate = 0;
 	if (*String == '!') {
 		String++;
@@ -2476,7 +2508,11 @@ Trigger* GenerateTrigger(char* String)
 		Log(ERROR, "GameScript", "Malformed scripting trigger: %s", String);
 		return NULL;
 	}
-	return trigger;
+	if (compiledTriggers.size() >= MAX_COMPILED_CACHE) {
+		ClearCompiledCache();
+	}
+	compiledTriggers[key] = trigger;
+	return TriggerCopy(trigger);
 }
 
 Action* GenerateAction(const char* String)
@@ -2488,6 +2524,11 @@ Action* GenerateAction(const char* String)
 	if (InDebug&ID_ACTIONS) {
 		Log(WARNING, "GameScript", "Compiling:%s", String);
 	}
+	ActionCache::const_iterator cached = compiledActions.find(actionString);
+	if (cached != compiledActions.end()) {
+		free(actionString);
+		return ParamCopy(cached->second);
+	}
 	int len = strlench(String,'(')+1; //including (
 	char *src = actionString+len;
 	int i = -1;
@@ -2514,6 +2555,13 @@ Action* GenerateAction(const char* String)
 		Log(ERROR, "GameScript", "Malformed scripting action: %s", String);
 		goto done;
 	}
+	if (compiledActions.size() >= MAX_COMPILED_CACHE) {
+		ClearCompiledCache();
+	}
+	// the cache holds the prototype's only reference
+	action->IncRef();
+	compiledActions[actionString] = action;
+	action = ParamCopy(action);
 	done:
 	free(actionString);
 	return action;
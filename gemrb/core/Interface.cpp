@@ -58,6 +58,7 @@
 #include "PluginMgr.h"
 #include "Predicates.h"
 #include "ProjectileServer.h"
+#include "ResourceSource.h"
 #include "SaveGameIterator.h"
 #include "SaveGameMgr.h"
 #include "ScriptEngine.h"
@@ -68,6 +69,8 @@
 #include "StringMgr.h"
 #include "SymbolMgr.h"
 #include "TileMap.h"
+#include "TileOverlay.h"
+#include "TileSet.h"
 #include "VEFObject.h"
 #include "Video.h"
 #include "WindowMgr.h"
@@ -83,15 +86,18 @@
 #include "GUI/Window.h"
 #include "GUI/WorldMapControl.h"
 #include "RNG/RNG_SFMT.h"
+#include "Scriptable/Actor.h"
 #include "Scriptable/Container.h"
 #include "System/FileStream.h"
 #include "System/VFS.h"
 #include "System/StringBuffer.h"
+#include "System/Threading.h"
 
 #ifdef HAVE_UNISTD_H
 #include <unistd.h>
 #endif
 
+#include <utility>
 #include <vector>
 
 namespace GemRB {
@@ -121,6 +127,69 @@ static ieWord IDT_SKILLPENALTY = 3;
 
 static int MagicBit = 0;
 
+// the startup phases with their time in microseconds,
+// each one lasts until the next one starts
+static std::vector<std::pair<const char*, unsigned long> > startupPhases;
+static unsigned __int64 phaseStart = 0;
+
+static void StartPhase(const char* name)
+{
+	unsigned __int64 now = GetMicroTicks();
+	if (!startupPhases.empty()) {
+		startupPhases.back().second = (unsigned long) (now - phaseStart);
+	}
+	phaseStart = now;
+	if (name) {
+		Log(MESSAGE, "Core", "%s", name);
+		startupPhases.push_back(std::make_pair(name, 0ul));
+	}
+}
+
+static void ReportPhases()
+{
+	StartPhase(NULL);
+	unsigned long total = 0;
+	for (size_t i = 0; i < startupPhases.size(); i++) {
+		Log(DEBUG, "Core", "%6lu ms %s", startupPhases[i].second / 1000, startupPhases[i].first);
+		total += startupPhases[i].second;
+	}
+	Log(MESSAGE, "Core", "Initialization took %lu ms.", total / 1000);
+	startupPhases.clear();
+}
+
+// opens chitin.key while the video driver and the search path are set up
+class OpenKeyTask : public Task {
+public:
+	OpenKeyTask(const char* path)
+		: source(PLUGIN_RESOURCE_KEY), opened(false)
+	{
+		strlcpy(this->path, path, _MAX_PATH);
+	}
+
+	void Run()
+	{
+		opened = source && source->Open(path, "chitin.key");
+	}
+
+	PluginHolder<ResourceSource> source;
+	char path[_MAX_PATH];
+	bool opened;
+};
+
+// reads the string table index while the sprites and fonts are loaded
+class OpenStringsTask : public Task {
+public:
+	OpenStringsTask() : strings(NULL), stream(NULL) {}
+
+	void Run()
+	{
+		strings->Open(stream);
+	}
+
+	StringMgr* strings;
+	DataStream* stream;
+};
+
 Interface::Interface()
 {
 	Log(MESSAGE, "Core", "GemRB Core Version v%s Loading...", VERSION_GEMRB );
@@ -333,6 +402,10 @@ Interface::~Interface(void)
 	delete calendar;
 	delete worldmap;
 	delete keymap;
+	TileOverlay::SetDrawThreads(1);
+	TileSet::SetPrefetch(0);
+	// join the prefetch threads while gamedata is still alive
+	ResourceManager::SetPrefetch(0);
 
 	FreeAbilityTables();
 
@@ -994,6 +1067,8 @@ void Interface::Main()
 		HandleGUIBehaviour();
 
 		GameLoop();
+		AudioDriver->Update();
+		ProcessLogQueue();
 		DrawWindows(true);
 		if (DrawFPS) {
 			frame++;
@@ -1007,6 +1082,7 @@ void Interface::Main()
 			video->DrawRect( fpsRgn, ColorBlack );
 			fps->Print( fpsRgn, String(fpsstring), palette,
 					   IE_FONT_ALIGN_LEFT | IE_FONT_ALIGN_MIDDLE | IE_FONT_SINGLE_LINE );
+			video->InvalidateRegion( fpsRgn );
 		}
 		if (TickHook)
 			TickHook();
@@ -1048,7 +1124,7 @@ int Interface::LoadSprites()
 		return GEM_ERROR;
 	}
 
-	Log(MESSAGE, "Core", "Loading Cursors...");
+	StartPhase("Loading Cursors...");
 	AnimationFactory* anim;
 	anim = (AnimationFactory*) gamedata->GetFactoryResource("cursors", IE_BAM_CLASS_ID);
 	if (anim)
@@ -1070,8 +1146,8 @@ int Interface::LoadSprites()
 	video->SetCursor( Cursors[1], VID_CUR_DOWN );
 
 	// Load fog-of-war bitmaps
+	StartPhase("Loading Fog-Of-War bitmaps...");
 	anim = (AnimationFactory*) gamedata->GetFactoryResource("fogowar", IE_BAM_CLASS_ID);
-	Log(MESSAGE, "Core", "Loading Fog-Of-War bitmaps...");
 	if (!anim || anim->GetCycleSize( 0 ) != 8) {
 		// unknown type of fog anim
 		Log(ERROR, "Core", "Failed to load Fog-of-War bitmaps.");
@@ -1144,7 +1220,7 @@ int Interface::LoadSprites()
 
 	// Load ground circle bitmaps (PST only)
 	//block required due to msvc6.0 incompatibility
-	Log(MESSAGE, "Core", "Loading Ground circle bitmaps...");
+	StartPhase("Loading Ground circle bitmaps...");
 	for (size = 0; size < MAX_CIRCLE_SIZE; size++) {
 		if (GroundCircleBam[size][0]) {
 			anim = (AnimationFactory*) gamedata->GetFactoryResource(GroundCircleBam[size], IE_BAM_CLASS_ID);
@@ -1167,8 +1243,8 @@ int Interface::LoadSprites()
 	}
 
 	if (!TooltipBackResRef.IsEmpty()) {
+		StartPhase("Initializing Tooltips...");
 		anim = (AnimationFactory*) gamedata->GetFactoryResource(TooltipBackResRef, IE_BAM_CLASS_ID);
-		Log(MESSAGE, "Core", "Initializing Tooltips...");
 		if (!anim) {
 			Log(ERROR, "Core", "Failed to initialize tooltips.");
 			return GEM_ERROR;
@@ -1186,7 +1262,7 @@ int Interface::LoadSprites()
 
 int Interface::LoadFonts()
 {
-	Log(MESSAGE, "Core", "Loading Fonts...");
+	StartPhase("Loading Fonts...");
 	AutoTable tab("fonts");
 	if (!tab) {
 		Log(ERROR, "Core", "Cannot find fonts.2da.");
@@ -1262,7 +1338,7 @@ int Interface::Init(InterfaceConfig* config)
 	plugin_flags = new Variables();
 	plugin_flags->SetType( GEM_VARIABLES_INT );
 
-	Log(MESSAGE, "Core", "Initializing the Event Manager...");
+	StartPhase("Initializing the Event Manager...");
 	evntmgr = new EventMgr();
 
 	lists = new Variables();
@@ -1292,9 +1368,11 @@ int Interface::Init(InterfaceConfig* config)
 	CONFIG_INT("CaseSensitive", CaseSensitive =);
 	CONFIG_INT("DoubleClickDelay", evntmgr->SetDCDelay);
 	CONFIG_INT("DrawFPS", DrawFPS = );
+	CONFIG_INT("EffectRefresh", Actor::SetEffectRefresh);
 	CONFIG_INT("EnableCheatKeys", EnableCheatKeys);
 	CONFIG_INT("EndianSwitch", DataStream::SetEndianSwitch);
 	CONFIG_INT("FogOfWar", FogOfWar = );
+	CONFIG_INT("FontCacheSize", Font::SetPrintCacheSize);
 	ieDword FullScreen = 0;
 	CONFIG_INT("FullScreen", FullScreen = );
 	vars->SetAt("Full Screen", FullScreen); //put into vars so that reading from game.ini wont overwrite
@@ -1302,14 +1380,23 @@ int Interface::Init(InterfaceConfig* config)
 	CONFIG_INT("TouchScrollAreas", TouchScrollAreas = );
 	CONFIG_INT("Height", Height = );
 	CONFIG_INT("KeepCache", KeepCache = );
+	CONFIG_INT("LogLevel", SetLogLevel);
 	MaxPartySize = 6;
 	CONFIG_INT("MaxPartySize", MaxPartySize = );
 	vars->SetAt("MaxPartySize", MaxPartySize); // for simple GUIScript access
+	CONFIG_INT("MovieDecodeAhead", MoviePlayer::SetDecodeAhead);
+	CONFIG_INT("MovieDecodeThreads", MoviePlayer::SetDecodeThreads);
 	CONFIG_INT("MultipleQuickSaves", MultipleQuickSaves = );
 	CONFIG_INT("RepeatKeyDelay", evntmgr->SetRKDelay);
+	CONFIG_INT("ResourcePrefetch", ResourceManager::SetPrefetch);
 	CONFIG_INT("SaveAsOriginal", SaveAsOriginal = );
 	CONFIG_INT("ScriptDebugMode", SetScriptDebugMode);
 	CONFIG_INT("SkipIntroVideos", SkipIntroVideos = );
+	CONFIG_INT("SoundCacheSize", Audio::SetCacheSize);
+	CONFIG_INT("SoundDecodeLatency", Audio::SetDecodeLatency);
+	CONFIG_INT("TileCacheSize", TileSet::SetBudget);
+	CONFIG_INT("TileDrawThreads", TileOverlay::SetDrawThreads);
+	CONFIG_INT("TilePrefetch", TileSet::SetPrefetch);
 	CONFIG_INT("TooltipDelay", TooltipDelay = );
 	CONFIG_INT("Width", Width = );
 	CONFIG_INT("IgnoreOriginalINI", IgnoreOriginalINI = );
@@ -1445,7 +1532,7 @@ int Interface::Init(InterfaceConfig* config)
 	}
 	if (!KeepCache) DelTree((const char *) CachePath, false);
 
-	Log(MESSAGE, "Core", "Starting Plugin Manager...");
+	StartPhase("Starting Plugin Manager...");
 	PluginMgr *plugin = PluginMgr::Get();
 #if TARGET_OS_MAC
 	// search the bundle plugins first
@@ -1465,8 +1552,17 @@ int Interface::Init(InterfaceConfig* config)
 	}
 	plugin->RunInitializers();
 
+	// independent work is done on a startup thread while this one goes on,
+	// each task is waited for right before its result is needed
+	char ChitinPath[_MAX_PATH];
+	PathJoin( ChitinPath, GamePath, "chitin.key", NULL );
+	OpenKeyTask keyTask(ChitinPath);
+	OpenStringsTask stringsTask;
+	WorkerPool startupPool(1);
+	startupPool.Submit(&keyTask);
+
 	Log(MESSAGE, "Core", "GemRB Core Initialization...");
-	Log(MESSAGE, "Core", "Initializing Video Driver...");
+	StartPhase("Initializing Video Driver...");
 	video = ( Video * ) PluginMgr::Get()->GetDriver(&Video::ID, VideoDriverName.c_str());
 	if (!video) {
 		Log(FATAL, "Core", "No Video Driver Available.");
@@ -1494,7 +1590,7 @@ int Interface::Init(InterfaceConfig* config)
 	SetInfoTextColor(defcolor);
 
 	{
-		Log(MESSAGE, "Core", "Initializing Search Path...");
+		StartPhase("Initializing Search Path...");
 		if (!IsAvailable( PLUGIN_RESOURCE_DIRECTORY )) {
 			Log(FATAL, "Core", "no DirectoryImporter!");
 			return GEM_ERROR;
@@ -1565,17 +1661,15 @@ int Interface::Init(InterfaceConfig* config)
 		gamedata->AddSource(path, "shared GemRB Unhardcoded data", PLUGIN_RESOURCE_CACHEDDIRECTORY);
 	}
 
-	{
-		Log(MESSAGE, "Core", "Initializing KEY Importer...");
-		char ChitinPath[_MAX_PATH];
-		PathJoin( ChitinPath, GamePath, "chitin.key", NULL );
-		if (!gamedata->AddSource(ChitinPath, "chitin.key", PLUGIN_RESOURCE_KEY)) {
-			Log(FATAL, "Core", "Failed to load \"chitin.key\"");
-			return GEM_ERROR;
-		}
+	StartPhase("Initializing KEY Importer...");
+	startupPool.Wait();
+	if (!keyTask.opened) {
+		Log(FATAL, "Core", "Failed to load \"chitin.key\"");
+		return GEM_ERROR;
 	}
+	gamedata->AddSource(keyTask.source);
 
-	Log(MESSAGE, "Core", "Initializing GUI Script Engine...");
+	StartPhase("Initializing GUI Script Engine...");
 	guiscript = PluginHolder<ScriptEngine>(IE_GUI_SCRIPT_CLASS_ID);
 	if (guiscript == NULL) {
 		Log(FATAL, "Core", "Missing GUI Script Engine.");
@@ -1599,7 +1693,7 @@ int Interface::Init(InterfaceConfig* config)
 	// Purposely add the font directory last since we will only ever need it at engine load time.
 	if (CustomFontPath[0]) gamedata->AddSource(CustomFontPath, "CustomFonts", PLUGIN_RESOURCE_DIRECTORY);
 
-	Log(MESSAGE, "Core", "Reading Game Options...");
+	StartPhase("Reading Game Options...");
 	if (!LoadGemRBINI()) {
 		Log(FATAL, "Core", "Cannot Load INI.");
 		return GEM_ERROR;
@@ -1638,24 +1732,24 @@ int Interface::Init(InterfaceConfig* config)
 	}
 	GameNameResRef[i] = 0;
 
-	Log(MESSAGE, "Core", "Reading Encoding Table...");
+	StartPhase("Reading Encoding Table...");
 	if (!LoadEncoding()) {
 		Log(ERROR, "Core", "Cannot Load Encoding.");
 	}
 
-	Log(MESSAGE, "Core", "Creating Projectile Server...");
+	StartPhase("Creating Projectile Server...");
 	projserv = new ProjectileServer();
 	if (!projserv->GetHighestProjectileNumber()) {
 		Log(ERROR, "Core", "No projectiles are available...");
 	}
 
-	Log(MESSAGE, "Core", "Checking for Dialogue Manager...");
+	StartPhase("Checking for Dialogue Manager...");
 	if (!IsAvailable( IE_TLK_CLASS_ID )) {
 		Log(FATAL, "Core", "No TLK Importer Available.");
 		return GEM_ERROR;
 	}
 	strings = PluginHolder<StringMgr>(IE_TLK_CLASS_ID);
-	Log(MESSAGE, "Core", "Loading Dialog.tlk file...");
+	StartPhase("Loading Dialog.tlk file...");
 	char strpath[_MAX_PATH];
 	PathJoin( strpath, GamePath, dialogtlk, NULL );
 	FileStream* fs = FileStream::OpenFile(strpath);
@@ -1663,10 +1757,12 @@ int Interface::Init(InterfaceConfig* config)
 		Log(FATAL, "Core", "Cannot find Dialog.tlk.");
 		return GEM_ERROR;
 	}
-	strings->Open(fs);
+	stringsTask.strings = strings.get();
+	stringsTask.stream = fs;
+	startupPool.Submit(&stringsTask);
 
 	{
-		Log(MESSAGE, "Core", "Loading Palettes...");
+		StartPhase("Loading Palettes...");
 		ResourceHolder<ImageMgr> pal16im(Palette16);
 		if (pal16im)
 			pal16 = pal16im->GetImage();
@@ -1688,16 +1784,16 @@ int Interface::Init(InterfaceConfig* config)
 		return GEM_ERROR;
 	}
 
-	Log(MESSAGE, "Core", "Initializing stock sounds...");
+	StartPhase("Initializing stock sounds...");
 	DSCount = ReadResRefTable ("defsound", DefSound);
 	if (DSCount == 0) {
 		Log(FATAL, "Core", "Cannot find defsound.2da.");
 		return GEM_ERROR;
 	}
 
-	Log(MESSAGE, "Core", "Broadcasting Event Manager...");
+	StartPhase("Broadcasting Event Manager...");
 	video->SetEventMgr( evntmgr );
-	Log(MESSAGE, "Core", "Initializing Window Manager...");
+	StartPhase("Initializing Window Manager...");
 	windowmgr = PluginHolder<WindowMgr>(IE_CHU_CLASS_ID);
 	if (windowmgr == NULL) {
 		Log(FATAL, "Core", "Failed to load Window Manager.");
@@ -1710,9 +1806,12 @@ int Interface::Init(InterfaceConfig* config)
 	ret = LoadFonts();
 	if (ret) return ret;
 
+	StartPhase("Waiting for Dialog.tlk...");
+	startupPool.Wait();
+
 	QuitFlag = QF_CHANGESCRIPT;
 
-	Log(MESSAGE, "Core", "Starting up the Sound Driver...");
+	StartPhase("Starting up the Sound Driver...");
 	AudioDriver = ( Audio * ) PluginMgr::Get()->GetDriver(&Audio::ID, AudioDriverName.c_str());
 	if (AudioDriver == NULL) {
 		Log(FATAL, "Core", "Failed to load sound driver.");
@@ -1723,7 +1822,7 @@ int Interface::Init(InterfaceConfig* config)
 		return GEM_ERROR;
 	}
 
-	Log(MESSAGE, "Core", "Allocating SaveGameIterator...");
+	StartPhase("Allocating SaveGameIterator...");
 	sgiterator = new SaveGameIterator();
 	if (sgiterator == NULL) {
 		Log(FATAL, "Core", "Failed to allocate SaveGameIterator.");
@@ -1735,7 +1834,7 @@ int Interface::Init(InterfaceConfig* config)
 	vars->SetAt( "GUIEnhancements", (unsigned long)GUIEnhancements );
 	vars->SetAt( "TouchScrollAreas", (unsigned long)TouchScrollAreas );
 
-	Log(MESSAGE, "Core", "Initializing Token Dictionary...");
+	StartPhase("Initializing Token Dictionary...");
 	tokens = new Variables();
 	if (!tokens) {
 		Log(FATAL, "Core", "Failed to allocate Token dictionary.");
@@ -1743,14 +1842,14 @@ int Interface::Init(InterfaceConfig* config)
 	}
 	tokens->SetType( GEM_VARIABLES_STRING );
 
-	Log(MESSAGE, "Core", "Initializing Music Manager...");
+	StartPhase("Initializing Music Manager...");
 	music = PluginHolder<MusicMgr>(IE_MUS_CLASS_ID);
 	if (!music) {
 		Log(FATAL, "Core", "Failed to load Music Manager.");
 		return GEM_ERROR;
 	}
 
-	Log(MESSAGE, "Core", "Loading music list...");
+	StartPhase("Loading music list...");
 	if (HasFeature( GF_HAS_SONGLIST )) {
 		ret = ReadMusicTable("songlist", 1);
 	} else {
@@ -1765,7 +1864,7 @@ int Interface::Init(InterfaceConfig* config)
 
 	int resdata = HasFeature( GF_RESDATA_INI );
 	if (resdata || HasFeature(GF_SOUNDS_INI) ) {
-		Log(MESSAGE, "Core", "Loading resource data File...");
+		StartPhase("Loading resource data File...");
 		INIresdata = PluginHolder<DataFileMgr>(IE_INI_CLASS_ID);
 		DataStream* ds = gamedata->GetResource(resdata? "resdata":"sounds", IE_INI_CLASS_ID);
 		if (!INIresdata->Open(ds)) {
@@ -1774,7 +1873,7 @@ int Interface::Init(InterfaceConfig* config)
 	}
 
 	if (HasFeature( GF_HAS_PARTY_INI )) {
-		Log(MESSAGE, "Core", "Loading precreated teams setup...");
+		StartPhase("Loading precreated teams setup...");
 		INIparty = PluginHolder<DataFileMgr>(IE_INI_CLASS_ID);
 		char tINIparty[_MAX_PATH];
 		PathJoin( tINIparty, GamePath, "Party.ini", NULL );
@@ -1789,7 +1888,7 @@ int Interface::Init(InterfaceConfig* config)
 	}
 
 	if (HasFeature( GF_HAS_BEASTS_INI )) {
-		Log(MESSAGE, "Core", "Loading beasts definition File...");
+		StartPhase("Loading beasts definition File...");
 		INIbeasts = PluginHolder<DataFileMgr>(IE_INI_CLASS_ID);
 		char tINIbeasts[_MAX_PATH];
 		PathJoin( tINIbeasts, GamePath, "beast.ini", NULL );
@@ -1799,7 +1898,7 @@ int Interface::Init(InterfaceConfig* config)
 			Log(WARNING, "Core", "Failed to load beast definitions.");
 		}
 
-		Log(MESSAGE, "Core", "Loading quests definition File...");
+		StartPhase("Loading quests definition File...");
 		INIquests = PluginHolder<DataFileMgr>(IE_INI_CLASS_ID);
 		char tINIquests[_MAX_PATH];
 		PathJoin( tINIquests, GamePath, "quests.ini", NULL );
@@ -1813,97 +1912,97 @@ int Interface::Init(InterfaceConfig* config)
 	calendar = NULL;
 	keymap = NULL;
 
-	Log(MESSAGE, "Core", "Bringing up the Global Timer...");
+	StartPhase("Bringing up the Global Timer...");
 	timer = new GlobalTimer();
 	if (!timer) {
 		Log(FATAL, "Core", "Failed to create global timer.");
 		return GEM_ERROR;
 	}
 
-	Log(MESSAGE, "Core", "Initializing effects...");
+	StartPhase("Initializing effects...");
 	ret = Init_EffectQueue();
 	if (!ret) {
 		Log(FATAL, "Core", "Failed to initialize effects.");
 		return GEM_ERROR;
 	}
 
-	Log(MESSAGE, "Core", "Initializing Inventory Management...");
+	StartPhase("Initializing Inventory Management...");
 	ret = InitItemTypes();
 	if (!ret) {
 		Log(FATAL, "Core", "Failed to initialize inventory.");
 		return GEM_ERROR;
 	}
 
-	Log(MESSAGE, "Core", "Initializing string constants...");
+	StartPhase("Initializing string constants...");
 	displaymsg = new DisplayMessage();
 	if (!displaymsg) {
 		Log(FATAL, "Core", "Failed to initialize string constants.");
 		return GEM_ERROR;
 	}
 
-	Log(MESSAGE, "Core", "Initializing random treasure...");
+	StartPhase("Initializing random treasure...");
 	ret = ReadRandomItems();
 	if (!ret) {
 		Log(WARNING, "Core", "Failed to initialize random treasure.");
 	}
 
-	Log(MESSAGE, "Core", "Initializing ability tables...");
+	StartPhase("Initializing ability tables...");
 	ret = ReadAbilityTables();
 	if (!ret) {
 		Log(FATAL, "Core", "Failed to initialize ability tables...");
 		return GEM_ERROR;
 	}
 
-	Log(MESSAGE, "Core", "Reading reputation mod table...");
+	StartPhase("Reading reputation mod table...");
 	ret = ReadReputationModTable();
 	if (!ret) {
 		Log(WARNING, "Core", "Failed to read reputation mod table.");
 	}
 
 	if ( gamedata->Exists("WMAPLAY", IE_2DA_CLASS_ID) ) {
-		Log(MESSAGE, "Core", "Initializing area aliases...");
+		StartPhase("Initializing area aliases...");
 		ret = ReadAreaAliasTable( "WMAPLAY" );
 		if (!ret) {
 			Log(WARNING, "Core", "Failed to load area aliases...");
 		}
 	}
 
-	Log(MESSAGE, "Core", "Reading game time table...");
+	StartPhase("Reading game time table...");
 	ret = ReadGameTimeTable();
 	if (!ret) {
 		Log(FATAL, "Core", "Failed to read game time table...");
 		return GEM_ERROR;
 	}
 
-	Log(MESSAGE, "Core", "Reading special spells table...");
+	StartPhase("Reading special spells table...");
 	ret = ReadSpecialSpells();
 	if (!ret) {
 		Log(WARNING, "Core", "Failed to load special spells.");
 	}
 
+	StartPhase("Reading damage type table...");
 	ret = ReadDamageTypeTable();
-	Log(MESSAGE, "Core", "Reading damage type table...");
 	if (!ret) {
 		Log(WARNING, "Core", "Reading damage type table...");
 	}
 
-	Log(MESSAGE, "Core", "Reading modal states table...");
+	StartPhase("Reading modal states table...");
 	ret = ReadModalStates();
 	if (!ret) {
 		Log(ERROR, "Core", "Failed to modal states table...");
 	}
 
-	Log(MESSAGE, "Core", "Reading game script tables...");
+	StartPhase("Reading game script tables...");
 	InitializeIEScript();
 
-	Log(MESSAGE, "Core", "Initializing keymap tables...");
+	StartPhase("Initializing keymap tables...");
 	keymap = new KeyMap();
 	ret = keymap->InitializeKeyMap("keymap.ini", "keymap");
 	if (!ret) {
 		Log(WARNING, "Core", "Failed to initialize keymaps.");
 	}
 
-	Log(MESSAGE, "Core", "Setting up the Console...");
+	StartPhase("Setting up the Console...");
 	console = new Console(Region(0, 0, Width, 25));
 	Sprite2D* cursor = GetCursorSprite();
 	if (!cursor) {
@@ -1911,6 +2010,7 @@ int Interface::Init(InterfaceConfig* config)
 	} else
 		console->SetCursor (cursor);
 
+	ReportPhases();
 	Log(MESSAGE, "Core", "Core Initialization Complete!");
 	return GEM_OK;
 }
@@ -2797,8 +2897,9 @@ void Interface::DisplayTooltip(int x, int y, Control *ctrl)
 			tooltip_sound->Stop();
 			tooltip_sound.release();
 		}
-		// exactly like PlaySound(DS_TOOLTIP) but storing the handle
-		tooltip_sound = AudioDriver->Play(DefSound[DS_TOOLTIP]);
+		// exactly like PlaySound(DS_TOOLTIP) but storing the handle,
+		// an unroll sound that comes late is worse than none
+		tooltip_sound = AudioDriver->Play(DefSound[DS_TOOLTIP], 0, 0, GEM_SND_RELATIVE|GEM_SND_SKIP_LATE);
 	}
 	tooltip_ctrl = ctrl;
 }
@@ -3027,6 +3128,7 @@ void Interface::DrawWindows(bool allow_delete)
 				shieldColor.a = 0xff;
 			}
 			video->DrawRect( Region( 0, 0, Width, Height ), shieldColor );
+			video->InvalidateScreen();
 			RedrawAll(); // wont actually have any effect until the modal window is dismissed.
 			modalShield = true;
 		}
@@ -3125,7 +3227,11 @@ void Interface::DrawTooltip ()
 	int x = strx + ((strw - w) / 2);
 
 	Region clip = Region( x, y, w, h );
+	// the tooltip is drawn over the finished frame
+	video->PrepareOverlay( clip );
 	if (TooltipBack) {
+		video->PrepareOverlay( Region( x - TooltipBack[1]->XPos, y - TooltipBack[1]->YPos, TooltipBack[1]->Width, TooltipBack[1]->Height ) );
+		video->PrepareOverlay( Region( x + w - TooltipBack[2]->XPos, y - TooltipBack[2]->YPos, TooltipBack[2]->Width, TooltipBack[2]->Height ) );
 		video->BlitSprite( TooltipBack[0], x + TooltipMargin - (TooltipBack[0]->Width - w) / 2, y, true, &clip );
 		video->BlitSprite( TooltipBack[1], x, y, true );
 		video->BlitSprite( TooltipBack[2], x + w, y, true );
@@ -3755,6 +3861,8 @@ void Interface::LoadGame(SaveGame *sg, int ver_override)
 	WorldMapArray* new_worldmap = NULL;
 
 	LoadProgress(10);
+	// anything prefetched belongs to the previous game or its cache
+	gamedata->ClearPrefetched();
 	if (!KeepCache) DelTree((const char *) CachePath, true);
 	LoadProgress(15);
 
@@ -4834,10 +4942,10 @@ ieStrRef Interface::GetRumour(const ieResRef dlgref)
 }
 
 //plays stock sound listed in defsound.2da
-void Interface::PlaySound(int index)
+void Interface::PlaySound(int index, unsigned int flags)
 {
 	if (index<=DSCount) {
-		AudioDriver->Play(DefSound[index]);
+		AudioDriver->Play(DefSound[index], 0, 0, flags);
 	}
 }
 
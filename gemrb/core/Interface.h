@@ -670,7 +670,7 @@ public:
 	void FreeSPLExt(SPLExtHeader *p, Effect *e);
 	WorldMapArray *NewWorldMapArray(int count);
 	/** plays stock gui sound referenced by index */
-	void PlaySound(int idx);
+	void PlaySound(int idx, unsigned int flags = GEM_SND_RELATIVE);
 	/** returns the first selected PC, if forced is set, then it returns
 	first PC if none was selected */
 	Actor *GetFirstSelectedPC(bool forced);
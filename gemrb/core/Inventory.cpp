@@ -38,6 +38,7 @@
 #include "Scriptable/Actor.h"
 #include "System/StringBuffer.h"
 
+#include <cassert>
 #include <cstdio>
 
 namespace GemRB {
@@ -100,10 +101,15 @@ Inventory::Inventory()
 	EquippedHeader = 0;
 	ItemExcl = 0;
 	memset(ItemTypes, 0, sizeof(ItemTypes));
+	equipBatch = 0;
+	equipRefresh = false;
 }
 
 Inventory::~Inventory()
 {
+	for (size_t i = 0; i < equipEffects.size(); i++) {
+		delete equipEffects[i].second;
+	}
 	for (size_t i = 0; i < Slots.size(); i++) {
 		if (Slots[i]) {
 			delete( Slots[i] );
@@ -223,7 +229,12 @@ void Inventory::AddSlotEffects(ieDword index)
 	EffectQueue *eqfx = itm->GetEffectBlock(Owner, Owner->Pos, -1, index, 0);
 	gamedata->FreeItem( itm, slot->ItemResRef, false );
 
-	Owner->RefreshEffects(eqfx);
+	if (equipBatch) {
+		equipEffects.push_back(std::make_pair(index, eqfx));
+		equipRefresh = true;
+	} else {
+		Owner->RefreshEffects(eqfx);
+	}
 	//call gui for possible paperdoll animation changes
 	if (Owner->InParty) {
 		core->SetEventFlag(EF_UPDATEANIM);
@@ -235,13 +246,52 @@ void Inventory::AddSlotEffects(ieDword index)
 void Inventory::RemoveSlotEffects(ieDword index)
 {
 	Owner->fxqueue.RemoveEquippingEffects(index);
-	Owner->RefreshEffects(NULL);
+	if (equipBatch) {
+		// the gathered effects of the slot weren't added yet, just drop them
+		for (size_t i = equipEffects.size(); i--; ) {
+			if (equipEffects[i].first == index) {
+				delete equipEffects[i].second;
+				equipEffects.erase(equipEffects.begin() + i);
+			}
+		}
+		equipRefresh = true;
+	} else {
+		Owner->RefreshEffects(NULL);
+	}
 	//call gui for possible paperdoll animation changes
 	if (Owner->InParty) {
 		core->SetEventFlag(EF_UPDATEANIM);
 	}
 }
 
+void Inventory::BeginEquipChanges()
+{
+	equipBatch++;
+}
+
+void Inventory::CommitEquipChanges()
+{
+	assert(equipBatch > 0);
+	if (--equipBatch || !equipRefresh) {
+		return;
+	}
+	equipRefresh = false;
+
+	// every block gets added on its own (with its own dice roll), only the
+	// last one goes through the refresh, which reapplies all of them
+	EffectQueue *last = NULL;
+	for (size_t i = 0; i < equipEffects.size(); i++) {
+		if (last) {
+			last->SetOwner(Owner);
+			last->AddAllEffects(Owner, Owner->Pos);
+			delete last;
+		}
+		last = equipEffects[i].second;
+	}
+	equipEffects.clear();
+	Owner->RefreshEffects(last);
+}
+
 void Inventory::SetInventoryType(int arg)
 {
 	InventoryType = arg;
@@ -1232,6 +1282,7 @@ bool Inventory::SetEquippedSlot(ieWordSigned slotcode, ieWord header)
 	int oldslot = GetEquippedSlot();
 	int newslot = GetWeaponSlot(slotcode);
 
+	BeginEquipChanges();
 	//remove previous slot effects
 	if (Equipped != IW_NO_EQUIPPED) {
 		RemoveSlotEffects(oldslot);
@@ -1250,6 +1301,7 @@ bool Inventory::SetEquippedSlot(ieWordSigned slotcode, ieWord header)
 		Equipped = IW_NO_EQUIPPED;
 		//fist slot equipping effects
 		AddSlotEffects(SLOT_FIST);
+		CommitEquipChanges();
 		UpdateWeaponAnimation();
 		return true;
 	}
@@ -1271,6 +1323,7 @@ bool Inventory::SetEquippedSlot(ieWordSigned slotcode, ieWord header)
 			AddSlotEffects(newslot);
 		}
 	}
+	CommitEquipChanges();
 	UpdateWeaponAnimation();
 	return true;
 }
@@ -35,10 +35,12 @@
 #include "Item.h"  //needs item for itmextheader
 #include "Store.h"
 
+#include <utility>
 #include <vector>
 
 namespace GemRB {
 
+class EffectQueue;
 class Map;
 class StringBuffer;
 
@@ -207,6 +209,12 @@ private:
 	/** this isn't saved */
 	ieDword ItemExcl;
 	ieDword ItemTypes[8]; //256 bits
+	/** nesting depth of BeginEquipChanges */
+	int equipBatch;
+	/** the owner's effects have to be refreshed on commit */
+	bool equipRefresh;
+	/** equipping effects gathered during a batch, by slot */
+	std::vector<std::pair<ieDword, EffectQueue*> > equipEffects;
 public: 
 	Inventory();
 	virtual ~Inventory();
@@ -286,6 +294,11 @@ public:
 	int GetShieldSlot() const;
 	void AddSlotEffects( ieDword slot);
 	//void AddAllEffects();
+	/** Starts a batch of equipment changes: slot effects are gathered and
+	 * the owner's effects are only refreshed by the matching commit.
+	 * Batches may nest, the outermost commit does the refresh. */
+	void BeginEquipChanges();
+	void CommitEquipChanges();
 	/** Returns item in specified slot. Does NOT change inventory */
 	CREItem* GetSlotItem(ieDword slot) const;
 	/** Returns the item's inventory flags */
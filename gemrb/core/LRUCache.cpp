@@ -30,16 +30,23 @@ struct VarEntry {
 	VarEntry* next;
 	void* data;
 	char* key;
+	size_t size;
 };
 
-LRUCache::LRUCache() : v(), head(0), tail(0) {
+LRUCache::LRUCache() : v(), head(0), tail(0), size(0) {
 	v.SetType(GEM_VARIABLES_POINTER);
 	v.ParseKey(1);
 }
 
 LRUCache::~LRUCache()
 {
-
+	// the values belong to the user
+	while (head) {
+		VarEntry* e = head;
+		head = e->next;
+		delete[] e->key;
+		delete e;
+	}
 }
 
 int LRUCache::GetCount() const
@@ -47,12 +54,14 @@ int LRUCache::GetCount() const
 	return v.GetCount();
 }
 
-void LRUCache::SetAt(const char* key, void* value)
+void LRUCache::SetAt(const char* key, void* value, size_t size)
 {
 	void* p;
 	if (v.Lookup(key, p)) {
 		VarEntry* e = (VarEntry*) p;
 		e->data = value;
+		this->size += size - e->size;
+		e->size = size;
 		Touch(key);
 		return;
 	}
@@ -61,6 +70,8 @@ void LRUCache::SetAt(const char* key, void* value)
 	e->prev = 0;
 	e->next = head;
 	e->data = value;
+	e->size = size;
+	this->size += size;
 	e->key = new char[strlen(key)+1];
 	strcpy(e->key, key);
 
@@ -110,6 +121,7 @@ bool LRUCache::Remove(const char* key)
 	VarEntry* e = (VarEntry*) p;
 	v.Remove(key);
 	removeFromList(e);
+	size -= e->size;
 	delete[] e->key;
 	delete e;
 	return true;
@@ -129,6 +141,16 @@ bool LRUCache::getLRU(unsigned int n, const char*& key, void*& value) const
 	return true;
 }
 
+bool LRUCache::Iterator::Next(const char*& key, void*& value)
+{
+	if (!e) return false;
+
+	key = e->key;
+	value = e->data;
+	e = e->prev;
+	return true;
+}
+
 void LRUCache::removeFromList(VarEntry* e)
 {
 	if (e->prev) {
@@ -34,24 +34,42 @@ public:
 	LRUCache();
 	~LRUCache();
 
-	// set value, overwriting any previous entry
-	void SetAt(const char* key, void* value);
+	// walks the entries from the least recently used one
+	class Iterator {
+	public:
+		// returns false after the most recently used entry. key remains
+		// owned by LRUCache. The returned entry may be removed or touched
+		// before the next call.
+		bool Next(const char*& key, void*& value);
+	private:
+		friend class LRUCache;
+		Iterator(VarEntry* e) : e(e) {}
+		VarEntry* e;
+	};
+
+	// set value, overwriting any previous entry. size is what the value
+	// accounts for in GetSize(), in whatever unit the user wants
+	void SetAt(const char* key, void* value, size_t size = 0);
 	bool Lookup(const char* key, void*& value) const;
 	bool Touch(const char* key);
 	bool Remove(const char* key);
 
 	int GetCount() const;
+	// sum of the sizes of all entries
+	size_t GetSize() const { return size; }
 
 	// return n-th LRU entry. key remains owned by LRUCache.
 	// (n = 0 is least recently used, n = 1 the next least recently used,
 	//  etc...)
 	bool getLRU(unsigned int n, const char*& key, void*& value) const;
+	Iterator GetLRUIterator() const { return Iterator(tail); }
 
 private:
 	// internal storage
 	Variables v;
 	VarEntry* head;
 	VarEntry* tail;
+	size_t size;
 
 	void removeFromList(VarEntry* e);
 };
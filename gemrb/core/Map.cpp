@@ -83,6 +83,10 @@ static Variables Spawns;
 static int LargeFog;
 static TerrainSounds *terrainsounds=NULL;
 static int tsndcount = -1;
+// sprite cover statistics
+static unsigned int coversBuilt = 0;
+static unsigned int coversReused = 0;
+static unsigned int coverFrames = 0;
 
 static void ReleaseSpawnGroup(void *poi)
 {
@@ -337,6 +341,8 @@ Map::Map(void)
 	SrchMap = NULL;
 	Walls = NULL;
 	WallCount = 0;
+	wallGridDirty = true;
+	nextExitCheck = 0;
 	queue[PR_SCRIPT] = NULL;
 	queue[PR_DISPLAY] = NULL;
 	INISpawn = NULL;
@@ -818,6 +824,22 @@ void Map::UpdateScripts()
 		container->Update();
 	}
 
+	//Find the infopoints each actor is near, so the actors far away
+	//don't need to go through the checks in Entered
+	trapActors.resize(TMap->GetInfoPointCount());
+	for (i = 0; i < trapActors.size(); i++) {
+		trapActors[i].clear();
+	}
+	q=Qcount[PR_SCRIPT];
+	while (q--) {
+		Actor* actor = queue[PR_SCRIPT][q];
+		int reach = actor->size*10;
+		TMap->GetTriggerCandidates(Region(actor->Pos.x - reach, actor->Pos.y - reach, 2*reach, 2*reach), nearbyInfoPoints);
+		for (size_t j = 0; j < nearbyInfoPoints.size(); j++) {
+			trapActors[nearbyInfoPoints[j]].push_back(q);
+		}
+	}
+
 	//Check if we need to start some trap scripts
 	int ipCount = 0;
 	while (true) {
@@ -841,10 +863,10 @@ void Map::UpdateScripts()
 		}
 
 		if (wasActive) {
-			q=Qcount[PR_SCRIPT];
+			const std::vector<int> &nearby = trapActors[ipCount-1];
 			ieDword exitID = ip->GetGlobalID();
-			while (q--) {
-				Actor* actor = queue[PR_SCRIPT][q];
+			for (size_t j = 0; j < nearby.size(); j++) {
+				Actor* actor = queue[PR_SCRIPT][nearby[j]];
 				if (ip->Type == ST_PROXIMITY) {
 					if(ip->Entered(actor)) {
 						//if trap triggered, then mark actor
@@ -878,10 +900,49 @@ void Map::UpdateScripts()
 	}
 
 	UpdateSpawns();
+	PrefetchExits();
 	GenerateQueues();
 	SortQueues();
 }
 
+//read the areas behind the exits near the party ahead, so using the exit
+//doesn't have to wait for the disk
+void Map::PrefetchExits()
+{
+	Game *game = core->GetGame();
+	if (game->GameTime < nextExitCheck) {
+		return;
+	}
+	nextExitCheck = game->GameTime + AI_UPDATE_TIME;
+
+	exitsPrefetched.resize(TMap->GetInfoPointCount(), false);
+	int q = Qcount[PR_SCRIPT];
+	while (q--) {
+		Actor* actor = queue[PR_SCRIPT][q];
+		if (!actor->InParty) {
+			continue;
+		}
+		// about half a screen
+		int reach = 400;
+		TMap->GetTriggerCandidates(Region(actor->Pos.x - reach, actor->Pos.y - reach, 2*reach, 2*reach), nearbyInfoPoints);
+		for (size_t i = 0; i < nearbyInfoPoints.size(); i++) {
+			unsigned int idx = nearbyInfoPoints[i];
+			InfoPoint* ip = TMap->GetInfoPoint(idx);
+			if (exitsPrefetched[idx] || ip->Type != ST_TRAVEL || !ip->Destination[0]) {
+				continue;
+			}
+			if (!stricmp(ip->Destination, GetScriptName()) || game->FindMap(ip->Destination) >= 0) {
+				continue;
+			}
+			exitsPrefetched[idx] = true;
+			gamedata->Prefetch(ip->Destination, IE_ARE_CLASS_ID);
+			// the tile map and its tileset are nearly always named after the area
+			gamedata->Prefetch(ip->Destination, IE_WED_CLASS_ID);
+			gamedata->Prefetch(ip->Destination, IE_TIS_CLASS_ID, false);
+		}
+	}
+}
+
 void Map::ResolveTerrainSound(ieResRef &sound, Point &Pos) {
 	for(int i=0;i<tsndcount;i++) {
 		if (!memcmp(sound, terrainsounds[i].Group, sizeof(ieResRef) ) ) {
@@ -1294,6 +1355,14 @@ void Map::DrawMap(Region screen)
 	}
 
 	oldgametime=gametime;
+
+	if (++coverFrames == 500) {
+		Log(DEBUG, "Map", "Built %.2f sprite covers per frame, reused %.2f",
+			coversBuilt / (double) coverFrames, coversReused / (double) coverFrames);
+		coversBuilt = 0;
+		coversReused = 0;
+		coverFrames = 0;
+	}
 }
 
 void Map::DrawSearchMap(const Region &screen)
@@ -1458,6 +1527,7 @@ void Map::InitActors()
 
 		actor->SetMap(this);
 		InitActor(actor);
+		actor->PreloadSounds();
 	}
 }
 
@@ -1483,6 +1553,8 @@ void Map::AddActor(Actor* actor, bool init)
 	strnlwrcpy(actor->Area, scriptName, 8);
 	if (!HasActor(actor)) {
 		actors.push_back( actor );
+		actorNames.Add(actor);
+		actorsByID[actor->GetGlobalID()] = actor;
 	}
 	if (init) {
 		actor->SetMap(this);
@@ -1514,6 +1586,8 @@ void Map::DeleteActor(int i)
 {
 	Actor *actor = actors[i];
 	if (actor) {
+		actorNames.Remove(actor);
+		actorsByID.erase(actor->GetGlobalID());
 		Game *game = core->GetGame();
 		//this makes sure that a PC will be demoted to NPC
 		game->LeaveParty( actor );
@@ -1562,42 +1636,21 @@ Door *Map::GetDoorByGlobalID(ieDword objectID)
 {
 	if (!objectID) return NULL;
 
-	int doorCount = 0;
-	while (true) {
-		Door* door = TMap->GetDoor( doorCount++ );
-		if (!door)
-			return NULL;
-		if (door->GetGlobalID() == objectID)
-			return door;
-	}
+	return TMap->GetDoorByGlobalID(objectID);
 }
 
 Container *Map::GetContainerByGlobalID(ieDword objectID)
 {
 	if (!objectID) return NULL;
 
-	int containerCount = 0;
-	while (true) {
-		Container* container = TMap->GetContainer( containerCount++ );
-		if (!container)
-			return NULL;
-		if (container->GetGlobalID() == objectID)
-			return container;
-	}
+	return TMap->GetContainerByGlobalID(objectID);
 }
 
 InfoPoint *Map::GetInfoPointByGlobalID(ieDword objectID)
 {
 	if (!objectID) return NULL;
 
-	int ipCount = 0;
-	while (true) {
-		InfoPoint* ip = TMap->GetInfoPoint( ipCount++ );
-		if (!ip)
-			return NULL;
-		if (ip->GetGlobalID() == objectID)
-			return ip;
-	}
+	return TMap->GetInfoPointByGlobalID(objectID);
 }
 
 Actor* Map::GetActorByGlobalID(ieDword objectID)
@@ -1605,15 +1658,11 @@ Actor* Map::GetActorByGlobalID(ieDword objectID)
 	if (!objectID) {
 		return NULL;
 	}
-	size_t i = actors.size();
-	while (i--) {
-		Actor* actor = actors[i];
-
-		if (actor->GetGlobalID()==objectID) {
-			return actor;
-		}
+	std::map<ieDword, Actor*>::const_iterator it = actorsByID.find(objectID);
+	if (it == actorsByID.end()) {
+		return NULL;
 	}
-	return NULL;
+	return it->second;
 }
 
 /** flags:
@@ -1703,6 +1752,15 @@ Actor **Map::GetAllActorsInRadius(const Point &p, int flags, unsigned int radius
 
 Actor* Map::GetActor(const char* Name, int flags)
 {
+	Actor* found;
+	size_t count = actorNames.Find(Name, found);
+	if (count < 2) {
+		if (found && !found->ValidTarget(flags)) {
+			return NULL;
+		}
+		return found;
+	}
+	// several actors share the name, the last added one is used
 	size_t i = actors.size();
 	while (i--) {
 		Actor* actor = actors[i];
@@ -2035,8 +2093,44 @@ unsigned int Map::GetBlocked(const Point &c)
 //	2 - always dither
 
 SpriteCover* Map::BuildSpriteCover(int x, int y, int xpos, int ypos,
-	unsigned int width, unsigned int height, int flags, bool areaanim)
-{
+	unsigned int width, unsigned int height, int flags, bool areaanim,
+	SpriteCover* reuse)
+{
+	if (wallGridDirty) {
+		wallGrid.Reset(TMap->XCellCount * 64, TMap->YCellCount * 64);
+		for (unsigned int i = 0; i < WallCount; ++i) {
+			if (Walls[i]) {
+				wallGrid.Insert(Walls[i]->BBox, i);
+			}
+		}
+		wallGridDirty = false;
+	}
+
+	// walls not overlapping the cover can't draw anything into it
+	Region coverRgn(x - xpos, y - ypos, width, height);
+	wallGrid.Query(coverRgn, nearbyWalls);
+	size_t count = 0;
+	for (size_t i = 0; i < nearbyWalls.size(); ++i) {
+		Wall_Polygon* wp = GetWallGroup(nearbyWalls[i]);
+		const Region& bbox = wp->BBox;
+		if (!Region(bbox.x - 1, bbox.y - 1, bbox.w + 2, bbox.h + 2).IntersectsRegion(coverRgn)) continue;
+		if (!wp->PointCovered(x, y)) continue;
+		if (areaanim && !(wp->GetPolygonFlag() & WF_COVERANIMS)) continue;
+
+		nearbyWalls[count++] = nearbyWalls[i];
+	}
+	nearbyWalls.resize(count);
+
+	// an empty cover only has to be moved
+	if (reuse && !reuse->walls && nearbyWalls.empty() && reuse->flags == flags &&
+		reuse->XPos == xpos && reuse->YPos == ypos &&
+		reuse->Width == (int) width && reuse->Height == (int) height) {
+		reuse->worldx = x;
+		reuse->worldy = y;
+		coversReused++;
+		return reuse;
+	}
+
 	SpriteCover* sc = new SpriteCover;
 	sc->worldx = x;
 	sc->worldy = y;
@@ -2048,18 +2142,11 @@ SpriteCover* Map::BuildSpriteCover(int x, int y, int xpos, int ypos,
 	Video* video = core->GetVideoDriver();
 	video->InitSpriteCover(sc, flags);
 
-	unsigned int wpcount = GetWallCount();
-	unsigned int i;
-
-	for (i = 0; i < wpcount; ++i)
-	{
-		Wall_Polygon* wp = GetWallGroup(i);
-		if (!wp) continue;
-		if (!wp->PointCovered(x, y)) continue;
-		if (areaanim && !(wp->GetPolygonFlag() & WF_COVERANIMS)) continue;
-
-		video->AddPolygonToSpriteCover(sc, wp);
+	for (size_t i = 0; i < nearbyWalls.size(); ++i) {
+		video->AddPolygonToSpriteCover(sc, GetWallGroup(nearbyWalls[i]));
 	}
+	sc->walls = (int) nearbyWalls.size();
+	coversBuilt++;
 
 	return sc;
 }
@@ -2082,10 +2169,25 @@ void Map::ActivateWallgroups(unsigned int baseindex, unsigned int count, int flg
 			value|=WF_DISABLED;
 		wp->SetPolygonFlag(value);
 	}
-	//all actors will have to generate a new spritecover
+	//the actors with a cover touching these walls will have to generate a new one
 	i=(int) actors.size();
 	while(i--) {
-		actors[i]->SetSpriteCover(NULL);
+		SpriteCover* sc = actors[i]->GetSpriteCover();
+		if (!sc) {
+			continue;
+		}
+		Region coverRgn(sc->worldx - sc->XPos, sc->worldy - sc->YPos, sc->Width, sc->Height);
+		for (unsigned int j = baseindex; j < baseindex+count; ++j) {
+			Wall_Polygon* wp = GetWallGroup(j);
+			if (!wp) {
+				continue;
+			}
+			const Region& bbox = wp->BBox;
+			if (Region(bbox.x - 1, bbox.y - 1, bbox.w + 2, bbox.h + 2).IntersectsRegion(coverRgn)) {
+				actors[i]->SetSpriteCover(NULL);
+				break;
+			}
+		}
 	}
 }
 
@@ -2333,6 +2435,8 @@ void Map::RemoveActor(Actor* actor)
 			actor->SetMap(NULL);
 			CopyResRef(actor->Area, "");
 			actors.erase( actors.begin()+i );
+			actorNames.Remove(actor);
+			actorsByID.erase(actor->GetGlobalID());
 			return;
 		}
 	}
@@ -4011,9 +4115,12 @@ void AreaAnimation::Draw(const Region &screen, Map *area)
 		Sprite2D *frame = anim->NextFrame();
 		if(covers) {
 			if(!covers[ac] || !covers[ac]->Covers(Pos.x, Pos.y + height, frame->XPos, frame->YPos, frame->Width, frame->Height)) {
-				delete covers[ac];
-				covers[ac] = area->BuildSpriteCover(Pos.x, Pos.y + height, -anim->animArea.x,
-					-anim->animArea.y, anim->animArea.w, anim->animArea.h, 0, true);
+				SpriteCover *sc = area->BuildSpriteCover(Pos.x, Pos.y + height, -anim->animArea.x,
+					-anim->animArea.y, anim->animArea.w, anim->animArea.h, 0, true, covers[ac]);
+				if (sc != covers[ac]) {
+					delete covers[ac];
+					covers[ac] = sc;
+				}
 			}
 		}
 		video->BlitGameSprite( frame, Pos.x + screen.x, Pos.y + screen.y,
@@ -25,9 +25,12 @@
 #include "globals.h"
 
 #include "Interface.h"
+#include "SpatialGrid.h"
 #include "Scriptable/Scriptable.h"
+#include "Scriptable/ScriptNameIndex.h"
 
 #include <algorithm>
+#include <map>
 #include <queue>
 
 namespace GemRB {
@@ -322,8 +325,21 @@ private:
 	unsigned int Width, Height;
 	std::list< AreaAnimation*> animations;
 	std::vector< Actor*> actors;
+	// lookup indexes for actors
+	ScriptNameIndex<Actor> actorNames;
+	std::map<ieDword, Actor*> actorsByID;
+	// UpdateScripts scratch: the script queue actors near each infopoint
+	std::vector<std::vector<int> > trapActors;
+	std::vector<unsigned int> nearbyInfoPoints;
+	// travel regions whose destination was already queued for prefetching
+	std::vector<bool> exitsPrefetched;
+	ieDword nextExitCheck;
 	Wall_Polygon **Walls;
 	unsigned int WallCount;
+	// wall polygons by position, for building sprite covers
+	SpatialGrid wallGrid;
+	bool wallGridDirty;
+	std::vector<unsigned int> nearbyWalls;
 	std::list< VEFObject*> vvcCells;
 	std::list< Projectile*> projectiles;
 	std::list< Particles*> particles;
@@ -382,9 +398,13 @@ public:
 	{
 		WallCount = count;
 		Walls = walls;
+		wallGridDirty = true;
 	}
+	/* builds a cover of the walls in front of x,y; if reuse is given and no
+	 * wall is near either, reuse is moved to x,y and returned instead */
 	SpriteCover* BuildSpriteCover(int x, int y, int xpos, int ypos,
-		unsigned int width, unsigned int height, int flag, bool areaanim = false);
+		unsigned int width, unsigned int height, int flag, bool areaanim = false,
+		SpriteCover* reuse = NULL);
 	void ActivateWallgroups(unsigned int baseindex, unsigned int count, int flg);
 	void Shout(Actor* actor, int shoutID, unsigned int radius);
 	void ActorSpottedByPlayer(Actor *actor);
@@ -575,6 +595,7 @@ private:
 	bool AdjustPositionY(Point &goal, unsigned int radiusx,  unsigned int radiusy);
 	void DrawPortal(InfoPoint *ip, int enable);
 	void UpdateSpawns();
+	void PrefetchExits();
 };
 
 }
@@ -20,10 +20,121 @@
 
 #include "MoviePlayer.h"
 
+#include "Audio.h"
+#include "Interface.h"
+#include "Video.h"
+#include "System/Threading.h"
+
+#include <deque>
+
 namespace GemRB {
 
 const TypeID MoviePlayer::ID = { "MoviePlayer" };
 
+int MoviePlayer::decodeThreads = -1;
+int MoviePlayer::decodeAhead = 4;
+
+// decodes frames into a bounded queue for PlayFrames
+class MovieDecoder : public Thread {
+public:
+	MovieDecoder(MoviePlayer* player, int frames)
+		: player(player), finished(false), stop(false)
+	{
+		for (int i = 0; i < frames; i++) {
+			free.push_back(new MoviePlayer::MovieFrame());
+		}
+	}
+	~MovieDecoder()
+	{
+		Stop();
+		for (size_t i = 0; i < free.size(); i++) {
+			delete free[i];
+		}
+		for (size_t i = 0; i < ready.size(); i++) {
+			delete ready[i];
+		}
+	}
+
+	// returns NULL at the end of the movie
+	MoviePlayer::MovieFrame* Next()
+	{
+		MutexLock l(mutex);
+		while (ready.empty() && !finished) {
+			changed.Wait(mutex);
+		}
+		if (ready.empty()) {
+			return NULL;
+		}
+		MoviePlayer::MovieFrame* frame = ready.front();
+		ready.pop_front();
+		return frame;
+	}
+
+	bool HasNext()
+	{
+		MutexLock l(mutex);
+		return !ready.empty();
+	}
+
+	void Release(MoviePlayer::MovieFrame* frame)
+	{
+		MutexLock l(mutex);
+		free.push_back(frame);
+		changed.Broadcast();
+	}
+
+	void Stop()
+	{
+		{
+			MutexLock l(mutex);
+			stop = true;
+			changed.Broadcast();
+		}
+		Join();
+	}
+
+protected:
+	void Run()
+	{
+		while (true) {
+			MoviePlayer::MovieFrame* frame;
+			{
+				MutexLock l(mutex);
+				while (free.empty() && !stop) {
+					changed.Wait(mutex);
+				}
+				if (stop) {
+					break;
+				}
+				frame = free.back();
+				free.pop_back();
+			}
+
+			frame->audio.clear();
+			bool decoded = player->DecodeFrame(*frame);
+
+			MutexLock l(mutex);
+			if (!decoded) {
+				free.push_back(frame);
+				break;
+			}
+			ready.push_back(frame);
+			changed.Broadcast();
+		}
+		MutexLock l(mutex);
+		finished = true;
+		changed.Broadcast();
+	}
+
+private:
+	MoviePlayer* player;
+	Mutex mutex;
+	ConditionVariable changed;
+	std::vector<MoviePlayer::MovieFrame*> free;
+	std::deque<MoviePlayer::MovieFrame*> ready;
+	bool finished, stop;
+};
+
 MoviePlayer::MoviePlayer(void)
 {
 }
@@ -32,4 +143,95 @@ MoviePlayer::~MoviePlayer(void)
 {
 }
 
+void MoviePlayer::SetDecodeThreads(int threads)
+{
+	decodeThreads = threads;
+}
+
+void MoviePlayer::SetDecodeAhead(int frames)
+{
+	decodeAhead = frames > 0 ? frames : 0;
+}
+
+void MoviePlayer::AddAudio(MovieFrame& frame, int stream, unsigned short bits,
+	int channels, const short* memory, int size, int samplerate)
+{
+	if (stream < 0 || size <= 0) {
+		return;
+	}
+	frame.audio.resize(frame.audio.size() + 1);
+	MovieAudio& audio = frame.audio.back();
+	audio.stream = stream;
+	audio.bits = bits;
+	audio.channels = channels;
+	audio.samplerate = samplerate;
+	audio.data.assign((const char*) memory, (const char*) memory + size);
+}
+
+bool MoviePlayer::PlayFrames(unsigned long frameTime)
+{
+	MovieDecoder decoder(this, decodeAhead);
+	bool threaded = decodeAhead && decoder.Start();
+	MovieFrame current;
+	unsigned __int64 start = 0;
+	unsigned int count = 0, dropped = 0;
+	bool done = false, droppedLast = false;
+	// for sleeping until a frame is due
+	Mutex timerMutex;
+	ConditionVariable timer;
+
+	while (!done) {
+		MovieFrame* frame = &current;
+		if (threaded) {
+			frame = decoder.Next();
+			if (!frame) break;
+		} else {
+			current.audio.clear();
+			if (!DecodeFrame(current)) break;
+		}
+
+		// the sound goes out even for dropped frames, so it doesn't stall
+		Audio* audio = core->GetAudioDrv();
+		for (size_t i = 0; i < frame->audio.size(); i++) {
+			MovieAudio& a = frame->audio[i];
+			audio->QueueBuffer(a.stream, a.bits, a.channels, (short*) &a.data[0], (int) a.data.size(), a.samplerate);
+		}
+
+		unsigned __int64 now = GetMicroTicks();
+		if (!start) {
+			start = now;
+		}
+		unsigned __int64 due = start + (unsigned __int64) count * frameTime;
+		count++;
+		// catch up only while there is a newer frame to show instead,
+		// without a decoder thread never twice in a row
+		bool late = frameTime && now > due + frameTime;
+		if (late && (threaded ? decoder.HasNext() : !droppedLast)) {
+			dropped++;
+			droppedLast = true;
+		} else {
+			droppedLast = false;
+			MutexLock l(timerMutex);
+			while (now < due && due - now >= 1000) {
+				timer.Wait(timerMutex, (unsigned int) ((due - now) / 1000));
+				now = GetMicroTicks();
+			}
+			ShowFrame(*frame);
+		}
+
+		if (threaded) {
+			decoder.Release(frame);
+		}
+		done = core->GetVideoDriver()->PollMovieEvents();
+	}
+	if (threaded) {
+		decoder.Stop();
+	}
+
+	if (dropped) {
+		Log(WARNING, "MoviePlayer", "Had to drop %u of %u video frame(s).", dropped, count);
+	}
+	return done;
+}
+
 }
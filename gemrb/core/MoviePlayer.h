@@ -33,20 +33,67 @@
 
 #include "Resource.h"
 
+#include <vector>
+
 namespace GemRB {
 
+class MovieDecoder;
+
 /**
  * @class MoviePlayer
  * Abstract loader and player for videos
  */
 
 class GEM_EXPORT MoviePlayer : public Resource {
+	friend class MovieDecoder;
 public:
 	static const TypeID ID;
 	MoviePlayer(void);
 	virtual ~MoviePlayer(void);
 	virtual int Play() = 0;
 	virtual void CallBackAtFrames(ieDword cnt, ieDword *frames, ieDword *strrefs) = 0;
+
+	/** Sets how many threads players may decode with, -1 for one per CPU */
+	static void SetDecodeThreads(int threads);
+	/** Sets how many frames PlayFrames() may decode before they are shown,
+	 * 0 decodes each one on the main thread when it is due */
+	static void SetDecodeAhead(int frames);
+
+protected:
+	/** Sound to queue on an audio stream */
+	struct MovieAudio {
+		int stream;
+		unsigned short bits;
+		int channels;
+		int samplerate;
+		std::vector<char> data;
+	};
+
+	/** A decoded frame and the sound that goes with it. The pixel
+	 * layout is up to the player. */
+	struct MovieFrame {
+		unsigned int number;
+		unsigned int width, height;
+		std::vector<unsigned char> pixels;
+		std::vector<MovieAudio> audio;
+	};
+
+	/** Decodes the next frame into frame, on the decoding thread when
+	 * decoding ahead. Returns false at the end of the movie. */
+	virtual bool DecodeFrame(MovieFrame& /*frame*/) { return false; }
+	/** Shows a decoded frame, always on the main thread. */
+	virtual void ShowFrame(MovieFrame& /*frame*/) {}
+	/** Adds a copy of the samples to the sound of frame */
+	static void AddAudio(MovieFrame& frame, int stream, unsigned short bits,
+		int channels, const short* memory, int size, int samplerate);
+	/** Plays the movie with DecodeFrame() and ShowFrame(), a frame every
+	 * frameTime microseconds. Late frames are dropped if the next one is
+	 * ready, while their sound is always queued. Returns true if the
+	 * player stopped it. */
+	bool PlayFrames(unsigned long frameTime);
+
+	static int decodeThreads;
+	static int decodeAhead;
 };
 
 }
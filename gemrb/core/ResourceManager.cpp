@@ -25,17 +25,67 @@
 #include "Resource.h"
 #include "ResourceDesc.h"
 #include "ResourceSource.h"
+#include "System/MemoryStream.h"
 #include "System/StringBuffer.h"
 
+#include <cctype>
+
 namespace GemRB {
 
+static WorkerPool* prefetchPool = NULL;
+static unsigned long prefetchBudget = 0;
+
+class ResourceManager::PrefetchTask : public Task {
+public:
+	PrefetchTask(ResourceManager* owner, DataStream* source, bool keep)
+		: owner(owner), source(source), data(NULL), keep(keep), done(false), serial(0)
+	{
+		size = source->Remains();
+		strlcpy(filename, source->filename, sizeof(filename));
+		strlcpy(originalfile, source->originalfile, _MAX_PATH);
+	}
+
+	void Run()
+	{
+		char* buffer = (char*) malloc(size ? size : 1);
+		if (buffer && source->Read(buffer, size) != (int) size) {
+			free(buffer);
+			buffer = NULL;
+		}
+		delete source;
+		source = NULL;
+		if (!keep) {
+			// nobody waits for these
+			free(buffer);
+			delete this;
+			return;
+		}
+		MutexLock l(owner->prefetchLock);
+		data = buffer;
+		done = true;
+		owner->prefetchDone.Broadcast();
+	}
+
+	ResourceManager* owner;
+	DataStream* source;
+	char* data;
+	unsigned long size;
+	char filename[16];
+	char originalfile[_MAX_PATH];
+	bool keep;
+	bool done;
+	unsigned int serial;
+};
+
 ResourceManager::ResourceManager()
+	: prefetchedSize(0), prefetchSerial(0)
 {
 }
 
 
 ResourceManager::~ResourceManager()
 {
+	ClearPrefetched();
 }
 
 bool ResourceManager::AddSource(const char *path, const char *description, PluginID type, int flags)
@@ -45,10 +95,15 @@ bool ResourceManager::AddSource(const char *path, const char *description, Plugi
 		Log(WARNING, "ResourceManager", "Invalid path given: %s (%s)", path, description);
 		return false;
 	}
+	AddSource(source, flags);
+	return true;
+}
 
+void ResourceManager::AddSource(Holder<ResourceSource> source, int flags)
+{
 	if (flags & RM_REPLACE_SAME_SOURCE) {
 		for (size_t i = 0; i < searchPath.size(); i++) {
-			if (!stricmp(description, searchPath[i]->GetDescription())) {
+			if (!stricmp(source->GetDescription(), searchPath[i]->GetDescription())) {
 				searchPath[i] = source;
 				break;
 			}
@@ -56,7 +111,8 @@ bool ResourceManager::AddSource(const char *path, const char *description, Plugi
 	} else {
 		searchPath.push_back(source);
 	}
-	return true;
+	// the new source may hide what was read from the old ones
+	ClearPrefetched();
 }
 
 static void PrintPossibleFiles(StringBuffer& buffer, const char* ResRef, const TypeID *type)
@@ -111,6 +167,14 @@ DataStream* ResourceManager::GetResource(const char* ResRef, SClass_ID type, boo
 {
 	if (ResRef[0] == '\0')
 		return NULL;
+	DataStream *prefetchedStream = TakePrefetched(ResRef, type);
+	if (prefetchedStream) {
+		if (!silent) {
+			Log(MESSAGE, "ResourceManager", "Found '%s.%s' in the prefetched data.",
+				ResRef, core->TypeExt(type));
+		}
+		return prefetchedStream;
+	}
 	for (size_t i = 0; i < searchPath.size(); i++) {
 		DataStream *ds = searchPath[i]->GetResource(ResRef, type);
 		if (ds) {
@@ -167,4 +231,119 @@ Resource* ResourceManager::GetResource(const char* ResRef, const TypeID *type, b
 	return NULL;
 }
 
+ResourceManager::PrefetchKey ResourceManager::MakeKey(const char* ResRef, SClass_ID type)
+{
+	std::string key;
+	for (int i = 0; i < 8 && ResRef[i]; i++) {
+		key += (char) tolower((unsigned char) ResRef[i]);
+	}
+	return PrefetchKey(key, type);
+}
+
+void ResourceManager::Prefetch(const char* ResRef, SClass_ID type, bool keep)
+{
+	if (!prefetchPool || ResRef[0] == '\0') {
+		return;
+	}
+
+	PrefetchKey key = MakeKey(ResRef, type);
+	{
+		MutexLock l(prefetchLock);
+		if (prefetched.find(key) != prefetched.end()) {
+			return;
+		}
+	}
+	// finding the resource is left to this thread, the sources aren't thread safe
+	DataStream* ds = GetResource(ResRef, type, true);
+	if (!ds) {
+		return;
+	}
+	PrefetchTask* task = new PrefetchTask(this, ds, keep);
+	if (keep) {
+		MutexLock l(prefetchLock);
+		task->serial = prefetchSerial++;
+		prefetched[key] = task;
+		prefetchedSize += task->size;
+		TrimPrefetched();
+	}
+	prefetchPool->Submit(task);
+}
+
+// the lock has to be held by the caller
+void ResourceManager::TrimPrefetched()
+{
+	// drop the oldest finished ones, what is still being read is kept
+	while (prefetchedSize > prefetchBudget) {
+		PrefetchMap::iterator oldest = prefetched.end();
+		PrefetchMap::iterator it;
+		for (it = prefetched.begin(); it != prefetched.end(); it++) {
+			if (it->second->done && (oldest == prefetched.end() || it->second->serial < oldest->second->serial)) {
+				oldest = it;
+			}
+		}
+		if (oldest == prefetched.end()) {
+			break;
+		}
+		prefetchedSize -= oldest->second->size;
+		free(oldest->second->data);
+		delete oldest->second;
+		prefetched.erase(oldest);
+	}
+}
+
+DataStream* ResourceManager::TakePrefetched(const char* ResRef, SClass_ID type) const
+{
+	PrefetchTask* task;
+	{
+		MutexLock l(prefetchLock);
+		if (prefetched.empty()) {
+			return NULL;
+		}
+		PrefetchMap::iterator it = prefetched.find(MakeKey(ResRef, type));
+		if (it == prefetched.end()) {
+			return NULL;
+		}
+		task = it->second;
+		while (!task->done) {
+			prefetchDone.Wait(prefetchLock);
+		}
+		prefetched.erase(it);
+		prefetchedSize -= task->size;
+	}
+
+	DataStream* ds = NULL;
+	if (task->data) {
+		ds = new MemoryStream(task->originalfile, task->data, task->size);
+		strlcpy(ds->filename, task->filename, sizeof(ds->filename));
+	}
+	delete task;
+	return ds;
+}
+
+void ResourceManager::ClearPrefetched()
+{
+	MutexLock l(prefetchLock);
+	PrefetchMap::iterator it;
+	for (it = prefetched.begin(); it != prefetched.end(); it++) {
+		while (!it->second->done) {
+			prefetchDone.Wait(prefetchLock);
+		}
+		free(it->second->data);
+		delete it->second;
+	}
+	prefetched.clear();
+	prefetchedSize = 0;
+}
+
+void ResourceManager::SetPrefetch(int kilobytes)
+{
+	// pending tasks are still run before the threads quit
+	delete prefetchPool;
+	prefetchPool = NULL;
+	prefetchBudget = kilobytes > 0 ? (unsigned long) kilobytes * 1024 : 0;
+	if (prefetchBudget) {
+		prefetchPool = new WorkerPool(2);
+	}
+}
+
 }
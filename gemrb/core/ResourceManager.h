@@ -25,7 +25,11 @@
 #include "exports.h"
 
 #include "Holder.h"
+#include "System/Threading.h"
 
+#include <map>
+#include <string>
+#include <utility>
 #include <vector>
 
 #if defined(_MSC_VER) || defined(__sgi) // No SFINAE
@@ -56,6 +60,8 @@ public:
 	 * @param[in] type Plugin type used for source.
 	 **/
 	bool AddSource(const char *path, const char *description, PluginID type, int flags=0);
+	/** Adds an already opened ResourceSource to the search path */
+	void AddSource(Holder<ResourceSource> source, int flags=0);
 
 	/** returns true if resource exists */
 	bool Exists(const char *ResRef, SClass_ID type, bool silent=false) const;
@@ -67,8 +73,37 @@ public:
 	/** Returns Resource object associated to given resource */
 	Resource* GetResource(const char* resname, const TypeID *type, bool silent = false, bool useCorrupt = false) const;
 
+	/**
+	 * Reads a resource on a background thread, if prefetching is enabled.
+	 * @param[in] keep If true, the next GetResource() of it is served from
+	 *                 memory, otherwise the data is only pulled into the
+	 *                 system's file cache, for big resources which are
+	 *                 streamed from disk anyway.
+	 **/
+	void Prefetch(const char* resname, SClass_ID type, bool keep = true);
+	/** Drops all unclaimed prefetched resources */
+	void ClearPrefetched();
+
+	/** Sets how many KiB of unclaimed prefetched resources are kept,
+	 * 0 disables prefetching */
+	static void SetPrefetch(int kilobytes);
+
 private:
+	class PrefetchTask;
+	friend class PrefetchTask;
+	typedef std::pair<std::string, SClass_ID> PrefetchKey;
+	typedef std::map<PrefetchKey, PrefetchTask*> PrefetchMap;
+
+	static PrefetchKey MakeKey(const char* resname, SClass_ID type);
+	DataStream* TakePrefetched(const char* resname, SClass_ID type) const;
+	void TrimPrefetched();
+
 	std::vector<Holder<ResourceSource> > searchPath;
+	mutable PrefetchMap prefetched;
+	mutable Mutex prefetchLock;
+	mutable ConditionVariable prefetchDone;
+	mutable unsigned long prefetchedSize;
+	unsigned int prefetchSerial;
 };
 
 }
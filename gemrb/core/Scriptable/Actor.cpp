@@ -173,6 +173,9 @@ static int animcount = -1;
 
 static int fiststat = IE_CLASS;
 
+//how effects are applied on refresh, see SetEffectRefresh
+static int effectRefresh = 0;
+
 //conversion for 3rd ed
 static int isclass[ISCLASSES]={0,0,0,0,0,0,0,0,0,0,0,0,0};
 
@@ -523,6 +526,8 @@ Actor::Actor()
 	RollSaves();
 	WMLevelMod = 0;
 	TicksLastRested = 0;
+	fxTouched = NULL;
+	fxGeneration = 0;
 	speed = 0;
 	WeaponType = AttackStance = 0;
 	DifficultyMargin = disarmTrap = 0;
@@ -570,6 +575,11 @@ void Actor::SetFistStat(ieDword stat)
 	fiststat = stat;
 }
 
+void Actor::SetEffectRefresh(int mode)
+{
+	effectRefresh = mode;
+}
+
 void Actor::SetDefaultActions(int qslot, ieByte slot1, ieByte slot2, ieByte slot3)
 {
 	QslotTranslation=qslot;
@@ -2767,6 +2777,15 @@ bool Actor::SetStat(unsigned int StatIndex, ieDword Value, int pcf)
 		return false;
 	}
 	Value = ClampStat(StatIndex, Value);
+	if (fxTouched) {
+		// only the value before the first change counts
+		size_t i;
+		for (i = 0; i < fxTouched->size() && (*fxTouched)[i].stat != StatIndex; i++) ;
+		if (i == fxTouched->size()) {
+			EffectStatChange change = { StatIndex, Modified[StatIndex], 0, BaseStats[StatIndex] };
+			fxTouched->push_back(change);
+		}
+	}
 
 	unsigned int previous = GetSafeStat(StatIndex);
 	if (Modified[StatIndex]!=Value) {
@@ -3026,7 +3045,7 @@ void Actor::RefreshEffects(EffectQueue *fx)
 		}
 	}
 
-	fxqueue.ApplyAllEffects( this );
+	ApplyEffects();
 
 	if (previous[IE_PUPPETID]) {
 		CheckPuppet(core->GetGame()->GetActorByGlobalID(previous[IE_PUPPETID]), previous[IE_PUPPETTYPE]);
@@ -3129,6 +3148,94 @@ void Actor::RefreshEffects(EffectQueue *fx)
 	}
 }
 
+void Actor::ApplyEffects()
+{
+	if (!effectRefresh) {
+		fxqueue.ApplyAllEffects(this);
+		return;
+	}
+
+	// Stat local effects are skipped when the stats they set start out as
+	// they did on the last refresh, their recorded results are used instead.
+	// So after a removed or changed effect only the other effects on its
+	// stats run again. The rest of the queue is applied as usual, in order,
+	// so they see the same stats as with a full refresh.
+	fxGeneration++;
+	std::list<Effect*>::const_iterator f = fxqueue.GetFirstEffect();
+	Effect *fx;
+	while ((fx = fxqueue.GetNextEffect(f))) {
+		if (fxqueue.IsStatLocal(fx)) {
+			ApplyStatLocalEffect(fx);
+		} else {
+			fxqueue.ReapplyEffect(this, fx);
+		}
+	}
+
+	// forget the effects that are gone
+	std::map<const Effect*, EffectRecord>::iterator it = fxRecords.begin();
+	while (it != fxRecords.end()) {
+		if (it->second.generation != fxGeneration) {
+			fxRecords.erase(it++);
+		} else {
+			++it;
+		}
+	}
+}
+
+void Actor::ApplyStatLocalEffect(Effect *fx)
+{
+	EffectRecord &record = fxRecords[fx];
+	bool same = record.reusable && record.generation
+		&& record.Opcode == fx->Opcode && record.TimingMode == fx->TimingMode
+		&& record.Parameter1 == fx->Parameter1 && record.Parameter2 == fx->Parameter2
+		&& record.Parameter3 == fx->Parameter3 && record.Parameter4 == fx->Parameter4;
+	size_t i;
+	for (i = 0; same && i < record.changes.size(); i++) {
+		const EffectStatChange &change = record.changes[i];
+		same = Modified[change.stat] == change.before && BaseStats[change.stat] == change.base;
+	}
+	record.generation = fxGeneration;
+
+	if (same) {
+		if (effectRefresh > 1) {
+			// validation: apply it anyway and compare
+			fxqueue.ApplyEffect(this, fx, 0);
+			for (i = 0; i < record.changes.size(); i++) {
+				const EffectStatChange &change = record.changes[i];
+				if (Modified[change.stat] != change.after) {
+					Log(ERROR, "Actor", "Incremental effect refresh of %s got %d instead of %d for stat %d (opcode %d)!",
+						LongName, change.after, Modified[change.stat], change.stat, fx->Opcode);
+				}
+			}
+		}
+		for (i = 0; i < record.changes.size(); i++) {
+			Modified[record.changes[i].stat] = record.changes[i].after;
+		}
+		return;
+	}
+
+	record.Opcode = fx->Opcode;
+	record.TimingMode = fx->TimingMode;
+	record.Parameter1 = fx->Parameter1;
+	record.Parameter2 = fx->Parameter2;
+	record.Parameter3 = fx->Parameter3;
+	record.Parameter4 = fx->Parameter4;
+	record.changes.clear();
+	fxTouched = &record.changes;
+	fxqueue.ApplyEffect(this, fx, 0);
+	fxTouched = NULL;
+
+	// the post change functions can't be skipped
+	record.reusable = true;
+	for (i = 0; i < record.changes.size(); i++) {
+		EffectStatChange &change = record.changes[i];
+		change.after = Modified[change.stat];
+		if (post_change_functions[change.stat]) {
+			record.reusable = false;
+		}
+	}
+}
+
 int Actor::GetProficiency(int proftype) const
 {
 	switch(proftype) {
@@ -4425,6 +4532,30 @@ void Actor::PlayWalkSound()
 	}
 }
 
+void Actor::PreloadSounds()
+{
+	ieResRef Sound;
+
+	int cnt = anims ? anims->GetWalkSoundCount() : 0;
+	if (!cnt) return;
+
+	strnuprcpy(Sound, anims->GetWalkSound(), sizeof(ieResRef)-1 );
+	area->ResolveTerrainSound(Sound, Pos);
+	if (Sound[0] == '*') return;
+
+	// the same variants PlayWalkSound picks from
+	Audio *audio = core->GetAudioDrv();
+	audio->Preload(Sound);
+	int l = strlen(Sound);
+	if (l < 8) {
+		for (int i = 1; i < cnt; i++) {
+			Sound[l] = i + 0x60;
+			Sound[l+1] = 0;
+			audio->Preload(Sound);
+		}
+	}
+}
+
 // guesses from audio:               bone  chain studd leather splint none other plate
 static const char *armor_types[8] = { "BN", "CH", "CL", "LR", "ML", "MM", "MS", "PT" };
 static const char *dmg_types[5] = { "PC", "SL", "BL", "ML", "RK" };
@@ -4623,6 +4754,8 @@ void Actor::SetMap(Map *map)
 		//apply persistent feat spells
 		ApplyExtraSettings();
 
+		// equip everything with a single effect refresh
+		inventory.BeginEquipChanges();
 		int SlotCount = inventory.GetSlotCount();
 		for (int Slot = 0; Slot<SlotCount;Slot++) {
 			int slottype = core->QuerySlotEffects( Slot );
@@ -4645,6 +4778,7 @@ void Actor::SetMap(Map *map)
 		//find a quiver for the bow, etc
 		inventory.EquipItem(inventory.GetEquippedSlot());
 		SetEquippedQuickSlot(inventory.GetEquipped(), inventory.GetEquippedHeader());
+		inventory.CommitEquipChanges();
 	}
 }
 
@@ -7604,7 +7738,7 @@ void Actor::DrawActorSprite(const Region &screen, int cx, int cy, const Region&
 					cy, -anims[0]->animArea.x,
 					-anims[0]->animArea.y,
 					anims[0]->animArea.w,
-					anims[0]->animArea.h, WantDither() );
+					anims[0]->animArea.h, WantDither(), false, newsc );
 			}
 			assert(newsc->Covers(cx, cy, nextFrame->XPos, nextFrame->YPos, nextFrame->Width, nextFrame->Height));
 
@@ -33,6 +33,7 @@
 #include "EffectQueue.h"
 #include "Palette.h"
 
+#include <map>
 #include <vector>
 
 namespace GemRB {
@@ -255,6 +256,26 @@ struct WeaponInfo {
 	WeaponInfo(): slot(0), enchantment(0), range(0), itemflags(0), prof(0), backstabbing(false), wflags(0), critmulti(0), critrange(0), profdmgbon(0), launcherdmgbon(0) {};
 };
 
+// a stat set by an effect during a refresh, with the value it had before,
+// the one it was set to and its base value (see Actor::ApplyEffects)
+struct EffectStatChange {
+	unsigned int stat;
+	ieDword before;
+	ieDword after;
+	ieDword base;
+};
+
+// what an EFFECT_STAT_LOCAL effect did on the last refresh
+struct EffectRecord {
+	ieDword Opcode, TimingMode;
+	ieDword Parameter1, Parameter2, Parameter3, Parameter4;
+	ieDword generation; // the refresh it was last seen in
+	bool reusable; // false if a stat it sets has a post change function
+	std::vector<EffectStatChange> changes;
+	EffectRecord() : Opcode(0), TimingMode(0), Parameter1(0), Parameter2(0),
+		Parameter3(0), Parameter4(0), generation(0), reusable(false) {}
+};
+
 struct BABTable {
 	ieDword level;
 	int bab; // basic attack bonus
@@ -367,6 +388,11 @@ private:
 	/*The projectile bringing the current attack*/
 	Projectile* attackProjectile ;
 	int TicksLastRested;
+	// incremental effect refresh: what each stat local effect did the last
+	// time, and where SetStat notes the changes of the one being applied
+	std::map<const Effect*, EffectRecord> fxRecords;
+	std::vector<EffectStatChange> *fxTouched;
+	ieDword fxGeneration;
 	/** paint the actor itself. Called internally by Draw() */
 	void DrawActorSprite(const Region &screen, int cx, int cy, const Region& bbox,
 				SpriteCover*& sc, Animation** anims,
@@ -392,6 +418,10 @@ private:
 	int GetProficiency(int proftype) const;
 	/** Re/Inits the Modified vector for PCs/NPCs */
 	void RefreshPCStats();
+	/** applies the effect queue on top of the unaffected Modified stats */
+	void ApplyEffects();
+	/** applies a stat local effect or repeats its recorded changes */
+	void ApplyStatLocalEffect(Effect *fx);
 	void RefreshHP();
 	bool ShouldHibernate();
 	bool ShouldDrawCircle() const;
@@ -411,6 +441,9 @@ public:
 	static void SetFistStat(ieDword stat);
 	/** sets game specific default data about action buttons */
 	static void SetDefaultActions(int qslot, ieByte slot1, ieByte slot2, ieByte slot3);
+	/** sets how effects are applied on refresh: 0 all of them, 1 only those
+	 * on changed stats where possible, 2 like 1 but checked against 0 */
+	static void SetEffectRefresh(int mode);
 	/** prints useful information on console */
 	void dump() const;
 	/** prints useful information to given buffer */
@@ -563,6 +596,8 @@ public:
 	void DisplayCombatFeedback (unsigned int damage, int resisted, int damagetype, Scriptable *hitter);
 	/* play a random footstep sound */
 	void PlayWalkSound();
+	/* starts decoding the walk sounds in the background */
+	void PreloadSounds();
 	/* play the proper hit sound (in pst) */
 	void PlayHitSound(DataFileMgr *resdata, int damagetype, bool suffix);
 	/* drops items from inventory to current spot */
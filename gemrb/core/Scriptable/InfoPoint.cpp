@@ -166,6 +166,19 @@ bool InfoPoint::TriggerTrap(int skill, ieDword ID)
 	return false;
 }
 
+//keep this in sync with the checks in Entered
+void InfoPoint::GetTriggerRegions(std::vector<Region> &regions) const
+{
+	int reach = (int) MAX_OPERATING_DISTANCE;
+	regions.push_back(outline->BBox);
+	if (Type == ST_TRAVEL) {
+		regions.push_back(Region(TrapLaunch.x - reach, TrapLaunch.y - reach, 2 * reach, 2 * reach));
+		regions.push_back(Region(TalkPos.x - reach, TalkPos.y - reach, 2 * reach, 2 * reach));
+	}
+	// the flag is checked by Entered, so this stays right if it changes
+	regions.push_back(Region(UsePoint.x - reach, UsePoint.y - reach, 2 * reach, 2 * reach));
+}
+
 bool InfoPoint::Entered(Actor *actor)
 {
 	if (outline->PointIn( actor->Pos ) ) {
@@ -23,6 +23,8 @@
 
 #include "Scriptable/Scriptable.h"
 
+#include <vector>
+
 namespace GemRB {
 
 class GEM_EXPORT InfoPoint : public Highlightable {
@@ -34,6 +36,8 @@ public:
 	bool TriggerTrap(int skill, ieDword ID);
 	//call this to check if an actor entered the trigger zone
 	bool Entered(Actor *actor);
+	//the regions Entered can succeed in, not counting the actor's personal space
+	void GetTriggerRegions(std::vector<Region> &regions) const;
   //returns true if
   ieDword GetUsePoint() const;
 	//checks if the actor may use this travel trigger
@@ -0,0 +1,179 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2016 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCRIPTNAMEINDEX_H
+#define SCRIPTNAMEINDEX_H
+
+#include "ie_types.h"
+
+#include "Scriptable/Scriptable.h"
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace GemRB {
+
+/**
+ * @class ScriptNameIndexBase
+ * The part of a name index the listed scriptables talk to. They report
+ * their renames and their destruction, so the index never has to be
+ * rebuilt or hold on to dead objects.
+ */
+
+class ScriptNameIndexBase {
+public:
+	virtual ~ScriptNameIndexBase() {}
+	/** Moves obj, listed under oldName, to its current script name */
+	virtual void Rename(Scriptable* obj, const char* oldName) = 0;
+	/** Drops obj from the index, it is being destroyed */
+	virtual void Forget(Scriptable* obj) = 0;
+
+protected:
+	bool IsListed(const Scriptable* obj) const
+	{
+		const std::vector<ScriptNameIndexBase*>& indexes = obj->nameIndexes;
+		return std::find(indexes.begin(), indexes.end(), this) != indexes.end();
+	}
+	void Listed(Scriptable* obj)
+	{
+		obj->nameIndexes.push_back(this);
+	}
+	void Unlisted(Scriptable* obj)
+	{
+		std::vector<ScriptNameIndexBase*>& indexes = obj->nameIndexes;
+		indexes.erase(std::remove(indexes.begin(), indexes.end(), this), indexes.end());
+	}
+};
+
+/**
+ * @class ScriptNameIndex
+ * Finds scriptables by their case folded script name.
+ * The owner adds and removes the objects as they come and go, the objects
+ * themselves keep their entry up to date when they are renamed.
+ */
+
+template <class T>
+class ScriptNameIndex : public ScriptNameIndexBase {
+public:
+	ScriptNameIndex() {}
+	~ScriptNameIndex()
+	{
+		typename IndexMap::iterator it;
+		for (it = index.begin(); it != index.end(); ++it) {
+			for (size_t i = 0; i < it->second.size(); i++) {
+				Unlisted(it->second[i]);
+			}
+		}
+	}
+
+	void Add(T* obj)
+	{
+		if (IsListed(obj)) {
+			return;
+		}
+		index[Key(obj->GetScriptName())].push_back(obj);
+		Listed(obj);
+	}
+
+	void Remove(T* obj)
+	{
+		if (!IsListed(obj)) {
+			return;
+		}
+		Unlisted(obj);
+		Erase(obj, obj->GetScriptName());
+	}
+
+	/** Returns how many objects have the name and sets obj to one of them.
+	 * Several objects may share a name, callers that care which one
+	 * they get have to look at the object list themselves then. */
+	size_t Find(const char* name, T*& obj) const
+	{
+		obj = NULL;
+		if (!name) {
+			return 0;
+		}
+		typename IndexMap::const_iterator it = index.find(Key(name));
+		if (it == index.end()) {
+			return 0;
+		}
+		obj = it->second.front();
+		return it->second.size();
+	}
+
+	void Rename(Scriptable* obj, const char* oldName)
+	{
+		T* entry = Erase(obj, oldName);
+		if (entry) {
+			index[Key(obj->GetScriptName())].push_back(entry);
+		}
+	}
+
+	void Forget(Scriptable* obj)
+	{
+		Erase(obj, obj->GetScriptName());
+	}
+
+private:
+	typedef std::map<std::string, std::vector<T*> > IndexMap;
+	IndexMap index;
+
+	// the objects point back at the index, so it can't be copied
+	ScriptNameIndex(const ScriptNameIndex&);
+	ScriptNameIndex& operator=(const ScriptNameIndex&);
+
+	// removes obj from the entry of name and returns it
+	T* Erase(Scriptable* obj, const char* name)
+	{
+		typename IndexMap::iterator it = index.find(Key(name));
+		if (it == index.end()) {
+			return NULL;
+		}
+		std::vector<T*>& objects = it->second;
+		for (size_t i = 0; i < objects.size(); i++) {
+			T* entry = objects[i];
+			if (static_cast<Scriptable*>(entry) != obj) {
+				continue;
+			}
+			objects.erase(objects.begin() + i);
+			if (objects.empty()) {
+				index.erase(it);
+			}
+			return entry;
+		}
+		return NULL;
+	}
+
+	// script names are compared case insensitively, up to 32 characters
+	static std::string Key(const char* name)
+	{
+		std::string key;
+		for (int i = 0; i < 32 && name[i]; i++) {
+			key += (char) tolower((unsigned char) name[i]);
+		}
+		return key;
+	}
+};
+
+}
+
+#endif
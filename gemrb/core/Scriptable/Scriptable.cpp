@@ -38,6 +38,7 @@
 #include "GUI/TextSystem/Font.h"
 #include "RNG/RNG_SFMT.h"
 #include "Scriptable/InfoPoint.h"
+#include "Scriptable/ScriptNameIndex.h"
 
 namespace GemRB {
 
@@ -140,6 +141,9 @@ Scriptable::~Scriptable(void)
 	}
 
 	delete( locals );
+	for (size_t i = 0; i < nameIndexes.size(); i++) {
+		nameIndexes[i]->Forget(this);
+	}
 }
 
 void Scriptable::SetScriptName(const char* text)
@@ -147,7 +151,14 @@ void Scriptable::SetScriptName(const char* text)
 	//if (text && text[0]) { //this leaves some uninitialized bytes
 	//lets hope this won't break anything
 	if (text) {
+		ieVariable oldName;
+		memcpy(oldName, scriptName, sizeof(ieVariable));
 		strnspccpy( scriptName, text, 32 );
+		if (strnicmp(oldName, scriptName, 32)) {
+			for (size_t i = 0; i < nameIndexes.size(); i++) {
+				nameIndexes[i]->Rename(this, oldName);
+			}
+		}
 	}
 }
 
@@ -27,6 +27,7 @@
 
 #include <list>
 #include <map>
+#include <vector>
 
 namespace GemRB {
 
@@ -42,6 +43,7 @@ class Map;
 class Movable;
 struct PathNode;
 class Scriptable;
+class ScriptNameIndexBase;
 class Selectable;
 class Spell;
 class Sprite2D;
@@ -364,6 +366,10 @@ public:
 	virtual char* GetName(int /*which*/) const { return NULL; }
 	bool AuraPolluted();
 private:
+	friend class ScriptNameIndexBase;
+	// the name indexes listing this object, told about renames
+	std::vector<ScriptNameIndexBase*> nameIndexes;
+
 	/* used internally to handle start of spellcasting */
 	int SpellCast(bool instant, Scriptable *target = NULL);
 	/* also part of the spellcasting process, creating the projectile */
@@ -0,0 +1,82 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2016 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "SpatialGrid.h"
+
+#include <algorithm>
+
+namespace GemRB {
+
+SpatialGrid::SpatialGrid(int cellSize)
+	: cellSize(cellSize), columns(1), rows(1), cells(1)
+{
+}
+
+void SpatialGrid::Reset(int width, int height)
+{
+	columns = std::max(1, (width + cellSize - 1) / cellSize);
+	rows = std::max(1, (height + cellSize - 1) / cellSize);
+	cells.clear();
+	cells.resize(columns * rows);
+}
+
+int SpatialGrid::CellX(int x) const
+{
+	if (x < 0) return 0;
+	return std::min(x / cellSize, columns - 1);
+}
+
+int SpatialGrid::CellY(int y) const
+{
+	if (y < 0) return 0;
+	return std::min(y / cellSize, rows - 1);
+}
+
+void SpatialGrid::Insert(const Region& rgn, unsigned int index)
+{
+	int x2 = CellX(rgn.x + rgn.w);
+	int y2 = CellY(rgn.y + rgn.h);
+	for (int y = CellY(rgn.y); y <= y2; y++) {
+		for (int x = CellX(rgn.x); x <= x2; x++) {
+			cells[y * columns + x].push_back(index);
+		}
+	}
+}
+
+const std::vector<unsigned int>& SpatialGrid::Query(const Point& p) const
+{
+	return cells[CellY(p.y) * columns + CellX(p.x)];
+}
+
+void SpatialGrid::Query(const Region& rgn, std::vector<unsigned int>& result) const
+{
+	result.clear();
+	int x2 = CellX(rgn.x + rgn.w);
+	int y2 = CellY(rgn.y + rgn.h);
+	for (int y = CellY(rgn.y); y <= y2; y++) {
+		for (int x = CellX(rgn.x); x <= x2; x++) {
+			const std::vector<unsigned int>& cell = cells[y * columns + x];
+			result.insert(result.end(), cell.begin(), cell.end());
+		}
+	}
+	std::sort(result.begin(), result.end());
+	result.erase(std::unique(result.begin(), result.end()), result.end());
+}
+
+}
@@ -0,0 +1,71 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2016 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/**
+ * @file SpatialGrid.h
+ * Declares SpatialGrid, a coarse lookup of area objects by position
+ * @author The GemRB Project
+ */
+
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include "exports.h"
+
+#include "Region.h"
+
+#include <vector>
+
+namespace GemRB {
+
+/**
+ * @class SpatialGrid
+ * Splits an area into square cells and remembers which objects have their
+ * bounding box in each cell, so position lookups only need to test the
+ * objects near the point. Objects are given by their index in the owner's
+ * list; positions outside the area are clamped to the border cells.
+ */
+
+class GEM_EXPORT SpatialGrid {
+public:
+	SpatialGrid(int cellSize = 128);
+
+	/** Empties the grid and sizes it for an area of width x height */
+	void Reset(int width, int height);
+	/** Registers the object for all cells its region touches, edges included.
+	 * Indexes have to be added in increasing order. */
+	void Insert(const Region& rgn, unsigned int index);
+	/** Returns the objects which may contain p, in increasing order */
+	const std::vector<unsigned int>& Query(const Point& p) const;
+	/** Collects the objects which may touch the region, in increasing
+	 * order and without duplicates */
+	void Query(const Region& rgn, std::vector<unsigned int>& result) const;
+
+private:
+	int CellX(int x) const;
+	int CellY(int y) const;
+
+	int cellSize;
+	int columns, rows;
+	std::vector<std::vector<unsigned int> > cells;
+};
+
+}
+
+#endif
@@ -29,6 +29,7 @@ SpriteCover::SpriteCover()
 {
 	pixels = 0;
 	worldx = worldy = XPos = YPos = Width = Height = flags = 0;
+	walls = 0;
 }
 
 SpriteCover::~SpriteCover()
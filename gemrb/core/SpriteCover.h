@@ -31,6 +31,7 @@ public:
 	int worldx, worldy; // world coords for which the cover has been computed
 	int XPos, YPos, Width, Height;
 	int flags;
+	int walls; // number of wall polygons drawn into pixels
 	SpriteCover(void);
 	~SpriteCover(void);
 
@@ -60,6 +60,9 @@ public:
 
 	bool SetLogLevel(log_level);
 	void log(log_level, const char* owner, const char* message, log_color color);
+	/** Returns false if the logger has to be written by the thread logging
+	 * the message instead of the logging thread */
+	virtual bool IsThreadSafe() const { return true; }
 protected:
 	virtual void LogInternal(log_level, const char*, const char*, log_color)=0;
 };
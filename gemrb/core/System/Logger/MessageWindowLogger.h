@@ -26,6 +26,8 @@ class GEM_EXPORT MessageWindowLogger : public Logger {
 public:
 	MessageWindowLogger( log_level = WARNING ); // this logger has a diffrent default level than its base class.
 	virtual ~MessageWindowLogger();
+	// it draws to the GUI, so it can't run on the logging thread
+	bool IsThreadSafe() const { return false; }
 protected:
 	void LogInternal(log_level level, const char* owner, const char* message, log_color color);
 private:
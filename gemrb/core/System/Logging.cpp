@@ -20,56 +20,364 @@
 
 #include "System/Logger.h"
 #include "System/StringBuffer.h"
+#include "System/Threading.h"
 
 #if defined(__sgi)
 #  include <stdarg.h>
 #else
 #  include <cstdarg>
 #endif
+#include <cstdio>
+#include <deque>
+#include <string>
 #include <vector>
 
 namespace GemRB {
 
+// the loggers which are written by the logging thread
 static std::vector<Logger*> theLogger;
+static Mutex loggerLock;
+// the ones which have to be written by the main thread
+static std::vector<Logger*> syncLogger;
+static log_level logLevel = DEBUG;
 
-void ShutdownLogging()
+#define LOG_QUEUE_SIZE 4096
+
+struct LogMessage {
+	log_level level;
+	log_color color;
+	std::string owner;
+	std::string message;
+};
+
+// guards syncLogger and syncQueue
+static Mutex syncLock;
+// messages other threads logged for syncLogger, written by the main thread,
+// when it holds LOG_QUEUE_SIZE messages new ones are dropped and counted
+static std::deque<LogMessage> syncQueue;
+static unsigned int syncDropped = 0, syncDroppedTotal = 0;
+
+static void WriteMessage(log_level level, const char* owner, const char* message, log_color color)
 {
+	MutexLock l(loggerLock);
 	for (size_t i = 0; i < theLogger.size(); ++i) {
-		theLogger[i]->destroy();
+		theLogger[i]->log(level, owner, message, color);
+	}
+}
+
+/**
+ * Writes the queued messages, so the threads logging them don't wait for
+ * the terminal or the disk. The queue is a fixed ring of messages, when it
+ * is full new messages are dropped and counted.
+ */
+class LogWriter : public Thread {
+public:
+	LogWriter()
+		: queue(LOG_QUEUE_SIZE), head(0), count(0), quit(false),
+		writing(false), dropped(0), droppedTotal(0)
+	{
+	}
+
+	~LogWriter()
+	{
+		Stop();
+	}
+
+	/** Returns false if the message has to be written by the caller */
+	bool Push(log_level level, const char* owner, const char* message, log_color color)
+	{
+		MutexLock l(lock);
+		if (quit) {
+			return false;
+		}
+		if (count == queue.size()) {
+			dropped++;
+			return true;
+		}
+		// the strings keep their buffers, so this doesn't allocate once warmed up
+		LogMessage& msg = queue[(head + count) % queue.size()];
+		msg.level = level;
+		msg.color = color;
+		msg.owner.assign(owner);
+		msg.message.assign(message);
+		count++;
+		pending.Signal();
+		return true;
+	}
+
+	void Flush()
+	{
+		MutexLock l(lock);
+		while (count || writing) {
+			drained.Wait(lock);
+		}
+	}
+
+	void Stop()
+	{
+		{
+			MutexLock l(lock);
+			quit = true;
+			pending.Signal();
+		}
+		Join();
+	}
+
+	unsigned int GetDropped()
+	{
+		MutexLock l(lock);
+		return droppedTotal + dropped;
+	}
+
+protected:
+	void Run()
+	{
+		LogMessage msg;
+		lock.Lock();
+		while (true) {
+			while (!count && !quit) {
+				pending.Wait(lock);
+			}
+			// whatever is queued is still written before quitting
+			if (!count) {
+				break;
+			}
+			msg.owner.swap(queue[head].owner);
+			msg.message.swap(queue[head].message);
+			msg.level = queue[head].level;
+			msg.color = queue[head].color;
+			head = (head + 1) % queue.size();
+			count--;
+			unsigned int lost = dropped;
+			droppedTotal += dropped;
+			dropped = 0;
+			writing = true;
+			lock.Unlock();
+
+			if (lost) {
+				char buf[64];
+				snprintf(buf, sizeof(buf), "%u messages were dropped, the log queue was full.", lost);
+				WriteMessage(WARNING, "Logger", buf, YELLOW);
+			}
+			WriteMessage(msg.level, msg.owner.c_str(), msg.message.c_str(), msg.color);
+
+			lock.Lock();
+			writing = false;
+			if (!count) {
+				drained.Broadcast();
+			}
+		}
+		lock.Unlock();
+	}
+
+private:
+	std::vector<LogMessage> queue;
+	size_t head, count;
+	bool quit, writing;
+	unsigned int dropped, droppedTotal;
+	Mutex lock;
+	ConditionVariable pending, drained;
+};
+
+static LogWriter* writer = NULL;
+
+// only for the main thread, the loggers are called unlocked, so they may log themselves
+static void WriteSync(log_level level, const char* owner, const char* message, log_color color)
+{
+	std::vector<Logger*> loggers;
+	{
+		MutexLock l(syncLock);
+		loggers = syncLogger;
+	}
+	for (size_t i = 0; i < loggers.size(); ++i) {
+		loggers[i]->log(level, owner, message, color);
+	}
+}
+
+void ShutdownLogging()
+{
+	if (writer) {
+		writer->Stop();
+		unsigned int dropped = writer->GetDropped();
+		delete writer;
+		writer = NULL;
+		if (dropped) {
+			char buf[64];
+			snprintf(buf, sizeof(buf), "%u messages were dropped in total.", dropped);
+			WriteMessage(WARNING, "Logger", buf, YELLOW);
+		}
+	}
+
+	ProcessLogQueue();
+	if (syncDroppedTotal && Thread::IsMainThread()) {
+		char buf[64];
+		snprintf(buf, sizeof(buf), "%u messages were dropped in total.", syncDroppedTotal);
+		WriteSync(WARNING, "Logger", buf, YELLOW);
+	}
+
+	{
+		MutexLock l(loggerLock);
+		for (size_t i = 0; i < theLogger.size(); ++i) {
+			theLogger[i]->destroy();
+		}
+		theLogger.clear();
+	}
+	MutexLock l(syncLock);
+	for (size_t i = 0; i < syncLogger.size(); ++i) {
+		syncLogger[i]->destroy();
 	}
-	theLogger.clear();
+	syncLogger.clear();
+	syncQueue.clear();
+	syncDropped = syncDroppedTotal = 0;
 }
 
 void InitializeLogging()
 {
+	Thread::SetMainThread();
 	AddLogger(createDefaultLogger());
+	writer = new LogWriter();
+	if (!writer->Start()) {
+		// everything is written right away then
+		delete writer;
+		writer = NULL;
+	}
 }
 
 void AddLogger(Logger* logger)
 {
-	if (logger)
+	if (!logger) {
+		return;
+	}
+	if (logger->IsThreadSafe()) {
+		MutexLock l(loggerLock);
 		theLogger.push_back(logger);
+	} else {
+		MutexLock l(syncLock);
+		syncLogger.push_back(logger);
+	}
+}
+
+static void RemoveFrom(std::vector<Logger*>& loggers, Logger* logger)
+{
+	std::vector<Logger*>::iterator itr = loggers.begin();
+	while (itr != loggers.end()) {
+		if (*itr == logger) {
+			itr = loggers.erase(itr);
+		} else {
+			itr++;
+		}
+	}
 }
 
 void RemoveLogger(Logger* logger)
 {
 	if (logger) {
-		std::vector<Logger*>::iterator itr = theLogger.begin();
-		while (itr != theLogger.end()) {
-			if (*itr == logger) {
-				itr = theLogger.erase(itr);
-			} else {
-				itr++;
-			}
+		if (logger->IsThreadSafe()) {
+			MutexLock l(loggerLock);
+			RemoveFrom(theLogger, logger);
+		} else {
+			MutexLock l(syncLock);
+			RemoveFrom(syncLogger, logger);
 		}
 		logger->destroy();
 		logger = NULL;
 	}
 }
 
+void SetLogLevel(int level)
+{
+	logLevel = (log_level) (level < FATAL ? FATAL : level);
+}
+
+void FlushLog()
+{
+	if (writer) {
+		writer->Flush();
+	}
+}
+
+void ProcessLogQueue()
+{
+	if (!Thread::IsMainThread()) {
+		return;
+	}
+	std::deque<LogMessage> queued;
+	unsigned int lost;
+	{
+		MutexLock l(syncLock);
+		if (syncQueue.empty() && !syncDropped) {
+			return;
+		}
+		queued.swap(syncQueue);
+		lost = syncDropped;
+		syncDroppedTotal += syncDropped;
+		syncDropped = 0;
+	}
+	for (size_t m = 0; m < queued.size(); ++m) {
+		const LogMessage& msg = queued[m];
+		WriteSync(msg.level, msg.owner.c_str(), msg.message.c_str(), msg.color);
+	}
+	// the dropped messages came after the queued ones
+	if (lost) {
+		char buf[64];
+		snprintf(buf, sizeof(buf), "%u messages were dropped, the log queue was full.", lost);
+		WriteSync(WARNING, "Logger", buf, YELLOW);
+	}
+}
+
+static void DispatchSync(log_level level, const char* owner, const char* message, log_color color)
+{
+	if (!Thread::IsMainThread()) {
+		MutexLock l(syncLock);
+		if (syncLogger.empty()) {
+			return;
+		}
+		if (syncQueue.size() == LOG_QUEUE_SIZE) {
+			syncDropped++;
+			return;
+		}
+		syncQueue.push_back(LogMessage());
+		LogMessage& msg = syncQueue.back();
+		msg.level = level;
+		msg.color = color;
+		msg.owner.assign(owner);
+		msg.message.assign(message);
+		return;
+	}
+
+	// keep the order the messages were logged in
+	ProcessLogQueue();
+	WriteSync(level, owner, message, color);
+}
+
+static void Dispatch(log_level level, const char* owner, const char* message, log_color color)
+{
+	DispatchSync(level, owner, message, color);
+	if (level == FATAL) {
+		// written right away, the queue could be full and a crash may follow
+		FlushLog();
+		WriteMessage(level, owner, message, color);
+	} else if (!writer || !writer->Push(level, owner, message, color)) {
+		WriteMessage(level, owner, message, color);
+	}
+}
+
+static bool HasLoggers()
+{
+	{
+		MutexLock l(loggerLock);
+		if (!theLogger.empty()) {
+			return true;
+		}
+	}
+	MutexLock l(syncLock);
+	return !syncLogger.empty();
+}
+
 static void vLog(log_level level, const char* owner, const char* message, log_color color, va_list ap)
 {
-	if (theLogger.empty())
+	// checked before formatting, so filtered messages cost next to nothing
+	if (level > logLevel || !HasLoggers())
 		return;
 
 	// Copied from System/StringBuffer.cpp
@@ -90,9 +398,7 @@ static void vLog(log_level level, const char* owner, const char* message, log_co
 #endif
 	char buf[len+1];
 	vsnprintf(buf, len + 1, message, ap);
-	for (size_t i = 0; i < theLogger.size(); ++i) {
-		theLogger[i]->log(level, owner, buf, color);
-	}
+	Dispatch(level, owner, buf, color);
 }
 
 void print(const char *message, ...)
@@ -125,9 +431,9 @@ void Log(log_level level, const char* owner, const char* message, ...)
 
 void Log(log_level level, const char* owner, StringBuffer const& buffer)
 {
-	for (size_t i = 0; i < theLogger.size(); ++i) {
-		theLogger[i]->log(level, owner, buffer.get().c_str(), WHITE);
-	}
+	if (level > logLevel)
+		return;
+	Dispatch(level, owner, buffer.get().c_str(), WHITE);
 }
 
 }
@@ -52,6 +52,13 @@ GEM_EXPORT void InitializeLogging();
 GEM_EXPORT void AddLogger(Logger*);
 GEM_EXPORT void RemoveLogger(Logger*);
 GEM_EXPORT void ShutdownLogging();
+/** Messages above this level are dropped before they are even formatted */
+GEM_EXPORT void SetLogLevel(int level);
+/** Waits until the logging thread wrote all queued messages */
+GEM_EXPORT void FlushLog();
+/** Writes what other threads logged for the loggers which aren't thread
+ * safe, does nothing unless called on the main thread */
+GEM_EXPORT void ProcessLogQueue();
 
 #if defined(__GNUC__)
 # define PRINTF_FORMAT(x, y) \
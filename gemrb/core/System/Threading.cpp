@@ -0,0 +1,327 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2016 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "System/Threading.h"
+
+#include <cassert>
+
+#ifndef WIN32
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace GemRB {
+
+#ifdef WIN32
+
+Mutex::Mutex()
+{
+	InitializeCriticalSection(&mutex);
+}
+
+Mutex::~Mutex()
+{
+	DeleteCriticalSection(&mutex);
+}
+
+void Mutex::Lock()
+{
+	EnterCriticalSection(&mutex);
+}
+
+void Mutex::Unlock()
+{
+	LeaveCriticalSection(&mutex);
+}
+
+ConditionVariable::ConditionVariable()
+{
+	InitializeConditionVariable(&cond);
+}
+
+ConditionVariable::~ConditionVariable()
+{
+}
+
+void ConditionVariable::Wait(Mutex& m)
+{
+	SleepConditionVariableCS(&cond, &m.mutex, INFINITE);
+}
+
+bool ConditionVariable::Wait(Mutex& m, unsigned int ms)
+{
+	return SleepConditionVariableCS(&cond, &m.mutex, ms) != 0;
+}
+
+void ConditionVariable::Signal()
+{
+	WakeConditionVariable(&cond);
+}
+
+void ConditionVariable::Broadcast()
+{
+	WakeAllConditionVariable(&cond);
+}
+
+DWORD WINAPI Thread::Entry(LPVOID arg)
+{
+	static_cast<Thread*>(arg)->Run();
+	return 0;
+}
+
+bool Thread::Start()
+{
+	assert(!running);
+	thread = CreateThread(NULL, 0, Entry, this, 0, NULL);
+	running = (thread != NULL);
+	return running;
+}
+
+void Thread::Join()
+{
+	if (!running) return;
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+	running = false;
+}
+
+int Thread::GetCPUCount()
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors > 0 ? (int) info.dwNumberOfProcessors : 1;
+}
+
+DWORD Thread::mainThread;
+
+void Thread::SetMainThread()
+{
+	mainThread = GetCurrentThreadId();
+	mainThreadSet = true;
+}
+
+bool Thread::IsMainThread()
+{
+	return !mainThreadSet || GetCurrentThreadId() == mainThread;
+}
+
+#else
+
+Mutex::Mutex()
+{
+	pthread_mutex_init(&mutex, NULL);
+}
+
+Mutex::~Mutex()
+{
+	pthread_mutex_destroy(&mutex);
+}
+
+void Mutex::Lock()
+{
+	pthread_mutex_lock(&mutex);
+}
+
+void Mutex::Unlock()
+{
+	pthread_mutex_unlock(&mutex);
+}
+
+ConditionVariable::ConditionVariable()
+{
+	pthread_cond_init(&cond, NULL);
+}
+
+ConditionVariable::~ConditionVariable()
+{
+	pthread_cond_destroy(&cond);
+}
+
+void ConditionVariable::Wait(Mutex& m)
+{
+	pthread_cond_wait(&cond, &m.mutex);
+}
+
+bool ConditionVariable::Wait(Mutex& m, unsigned int ms)
+{
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	long usec = now.tv_usec + (long) (ms % 1000) * 1000;
+	struct timespec until;
+	until.tv_sec = now.tv_sec + ms / 1000 + usec / 1000000;
+	until.tv_nsec = (usec % 1000000) * 1000;
+	return pthread_cond_timedwait(&cond, &m.mutex, &until) == 0;
+}
+
+void ConditionVariable::Signal()
+{
+	pthread_cond_signal(&cond);
+}
+
+void ConditionVariable::Broadcast()
+{
+	pthread_cond_broadcast(&cond);
+}
+
+void* Thread::Entry(void* arg)
+{
+	static_cast<Thread*>(arg)->Run();
+	return NULL;
+}
+
+bool Thread::Start()
+{
+	assert(!running);
+	running = (pthread_create(&thread, NULL, Entry, this) == 0);
+	return running;
+}
+
+void Thread::Join()
+{
+	if (!running) return;
+	pthread_join(thread, NULL);
+	running = false;
+}
+
+int Thread::GetCPUCount()
+{
+	long count = -1;
+#ifdef _SC_NPROCESSORS_ONLN
+	count = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	return count > 0 ? (int) count : 1;
+}
+
+pthread_t Thread::mainThread;
+
+void Thread::SetMainThread()
+{
+	mainThread = pthread_self();
+	mainThreadSet = true;
+}
+
+bool Thread::IsMainThread()
+{
+	return !mainThreadSet || pthread_equal(pthread_self(), mainThread);
+}
+
+#endif
+
+bool Thread::mainThreadSet = false;
+
+Thread::Thread()
+	: running(false)
+{
+}
+
+Thread::~Thread()
+{
+	// subclasses have to join, Run() can't be called on a destroyed object
+	assert(!running);
+}
+
+class WorkerPool::Worker : public Thread {
+public:
+	Worker(WorkerPool* p) : pool(p) {}
+	~Worker() { Join(); }
+
+protected:
+	void Run()
+	{
+		Task* task;
+		while ((task = pool->NextTask())) {
+			task->Run();
+			pool->TaskDone();
+		}
+	}
+
+private:
+	WorkerPool* pool;
+};
+
+WorkerPool::WorkerPool(int threads)
+	: busy(0), quit(false)
+{
+	for (int i = 0; i < threads; i++) {
+		Worker* worker = new Worker(this);
+		if (!worker->Start()) {
+			delete worker;
+			break;
+		}
+		workers.push_back(worker);
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		MutexLock l(mutex);
+		quit = true;
+		pending.Broadcast();
+	}
+	for (size_t i = 0; i < workers.size(); i++) {
+		delete workers[i];
+	}
+}
+
+void WorkerPool::Submit(Task* task)
+{
+	if (workers.empty()) {
+		// no threads (or none could be created), so do the work right here
+		task->Run();
+		return;
+	}
+	MutexLock l(mutex);
+	queue.push_back(task);
+	pending.Signal();
+}
+
+void WorkerPool::Wait()
+{
+	MutexLock l(mutex);
+	while (!queue.empty() || busy) {
+		idle.Wait(mutex);
+	}
+}
+
+Task* WorkerPool::NextTask()
+{
+	MutexLock l(mutex);
+	while (queue.empty() && !quit) {
+		pending.Wait(mutex);
+	}
+	if (queue.empty()) {
+		return NULL;
+	}
+	Task* task = queue.front();
+	queue.pop_front();
+	busy++;
+	return task;
+}
+
+void WorkerPool::TaskDone()
+{
+	MutexLock l(mutex);
+	busy--;
+	if (queue.empty() && !busy) {
+		idle.Broadcast();
+	}
+}
+
+}
@@ -0,0 +1,185 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2016 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/**
+ * @file Threading.h
+ * Declares the threading primitives used by the core: mutexes, condition
+ * variables, threads and a simple worker pool.
+ * @author The GemRB Project
+ */
+
+#ifndef THREADING_H
+#define THREADING_H
+
+#include "exports.h"
+
+#include <deque>
+#include <vector>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+namespace GemRB {
+
+class GEM_EXPORT Mutex {
+public:
+	Mutex();
+	~Mutex();
+
+	void Lock();
+	void Unlock();
+
+private:
+#ifdef WIN32
+	CRITICAL_SECTION mutex;
+#else
+	pthread_mutex_t mutex;
+#endif
+	friend class ConditionVariable;
+
+	Mutex(const Mutex&);
+	Mutex& operator=(const Mutex&);
+};
+
+/** Locks a mutex for the lifetime of the object. */
+class GEM_EXPORT MutexLock {
+public:
+	MutexLock(Mutex& m) : mutex(m) { mutex.Lock(); }
+	~MutexLock() { mutex.Unlock(); }
+
+private:
+	Mutex& mutex;
+
+	MutexLock(const MutexLock&);
+	MutexLock& operator=(const MutexLock&);
+};
+
+class GEM_EXPORT ConditionVariable {
+public:
+	ConditionVariable();
+	~ConditionVariable();
+
+	/** Waits for a signal, the mutex must be locked by the caller. */
+	void Wait(Mutex& m);
+	/** Like Wait(), but gives up after ms milliseconds and returns false. */
+	bool Wait(Mutex& m, unsigned int ms);
+	void Signal();
+	void Broadcast();
+
+private:
+#ifdef WIN32
+	CONDITION_VARIABLE cond;
+#else
+	pthread_cond_t cond;
+#endif
+
+	ConditionVariable(const ConditionVariable&);
+	ConditionVariable& operator=(const ConditionVariable&);
+};
+
+/**
+ * @class Thread
+ * Base class for threads, subclasses implement Run().
+ */
+
+class GEM_EXPORT Thread {
+public:
+	Thread();
+	virtual ~Thread();
+
+	bool Start();
+	/** Waits for Run() to return. */
+	void Join();
+	bool IsRunning() const { return running; }
+
+	/** Returns the number of processors available, at least 1. */
+	static int GetCPUCount();
+	/** Marks the calling thread as the main one. */
+	static void SetMainThread();
+	/** Returns true on the main thread, or if none was marked yet. */
+	static bool IsMainThread();
+
+protected:
+	virtual void Run() = 0;
+
+private:
+#ifdef WIN32
+	HANDLE thread;
+	static DWORD mainThread;
+	static DWORD WINAPI Entry(LPVOID arg);
+#else
+	pthread_t thread;
+	static pthread_t mainThread;
+	static void* Entry(void* arg);
+#endif
+	bool running;
+	static bool mainThreadSet;
+
+	Thread(const Thread&);
+	Thread& operator=(const Thread&);
+};
+
+/** A unit of work for a WorkerPool. */
+class GEM_EXPORT Task {
+public:
+	virtual ~Task() {}
+	virtual void Run() = 0;
+};
+
+/**
+ * @class WorkerPool
+ * A fixed set of threads running submitted tasks in submission order.
+ * Tasks are not owned by the pool.
+ */
+
+class GEM_EXPORT WorkerPool {
+public:
+	WorkerPool(int threads);
+	~WorkerPool();
+
+	void Submit(Task* task);
+	/** Blocks until every submitted task has finished. */
+	void Wait();
+	int GetThreadCount() const { return (int) workers.size(); }
+
+private:
+	class Worker;
+	friend class Worker;
+
+	Task* NextTask();
+	void TaskDone();
+
+	std::vector<Worker*> workers;
+	std::deque<Task*> queue;
+	Mutex mutex;
+	ConditionVariable pending;
+	ConditionVariable idle;
+	int busy;
+	bool quit;
+
+	WorkerPool(const WorkerPool&);
+	WorkerPool& operator=(const WorkerPool&);
+};
+
+}
+
+#endif
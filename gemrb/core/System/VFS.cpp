@@ -61,20 +61,20 @@
 
 using namespace GemRB;
 
+struct dirent {
+	char d_name[_MAX_PATH];
+};
+
 struct DIR {
 	char path[_MAX_PATH];
 	bool is_first;
 	struct _finddata_t c_file;
 	long hFile;
+	// buffer which readdir returns, one per directory so threads can
+	// list different directories at the same time
+	dirent de;
 };
 
-struct dirent {
-	char d_name[_MAX_PATH];
-};
-
-// buffer which readdir returns
-static dirent de;
-
 static DIR* opendir(const char* filename)
 {
 	DIR* dirp = ( DIR* ) malloc( sizeof( DIR ) );
@@ -101,9 +101,9 @@ static dirent* readdir(DIR* dirp)
 		}
 	}
 
-	strcpy( de.d_name, c_file.name );
+	strcpy( dirp->de.d_name, c_file.name );
 
-	return &de;
+	return &dirp->de;
 }
 
 static void closedir(DIR* dirp)
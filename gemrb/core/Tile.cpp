@@ -20,6 +20,8 @@
 
 #include "Tile.h"
 
+#include "TileSet.h"
+
 namespace GemRB {
 
 Tile::Tile(Animation* anim, Animation* sec)
@@ -27,6 +29,26 @@ Tile::Tile(Animation* anim, Animation* sec)
 	tileIndex = om = 0;
 	this->anim[0] = anim;
 	this->anim[1] = sec;
+	set = NULL;
+}
+
+Tile::Tile(TileSet* set, const unsigned short* indexes, int count,
+	const unsigned short* secondary)
+{
+	tileIndex = om = 0;
+	this->set = set;
+	// the animations only keep the time, their frames stay empty
+	anim[0] = new Animation( count );
+	//pause key stops animation
+	anim[0]->gameAnimation = true;
+	//the turning crystal in ar3202 (bg1) requires animations to be synced
+	anim[0]->pos = 0;
+	frames[0].assign(indexes, indexes + count);
+	anim[1] = NULL;
+	if (secondary) {
+		anim[1] = new Animation( count );
+		frames[1].assign(secondary, secondary + count);
+	}
 }
 
 Tile::~Tile(void)
@@ -35,4 +57,21 @@ Tile::~Tile(void)
 	delete( anim[1] );
 }
 
+Sprite2D* Tile::NextFrame(int which)
+{
+	Animation* ani = anim[which];
+	if (!set) {
+		return ani->NextFrame();
+	}
+	unsigned int frame = ani->GetCurrentFrame();
+	ani->NextFrame();
+	return set->GetTile(frames[which][frame]);
+}
+
+void Tile::GetTileIndexes(std::vector<unsigned short>& indexes) const
+{
+	indexes.insert(indexes.end(), frames[0].begin(), frames[0].end());
+	indexes.insert(indexes.end(), frames[1].begin(), frames[1].end());
+}
+
 }
@@ -26,12 +26,23 @@
 
 #include "Animation.h"
 
+#include <vector>
+
 namespace GemRB {
 
+class TileSet;
+
 class GEM_EXPORT Tile {
 public:
 	Tile(Animation* anim, Animation* sec = NULL);
+	/** A tile whose frames are decoded by the set when first drawn */
+	Tile(TileSet* set, const unsigned short* indexes, int count,
+		const unsigned short* secondary = NULL);
 	~Tile(void);
+	/** Returns the current frame of anim[which] and advances it */
+	Sprite2D* NextFrame(int which);
+	/** Adds the tileset indexes of all the frames, for prefetching */
+	void GetTileIndexes(std::vector<unsigned short>& indexes) const;
 	unsigned char tileIndex;
 	unsigned char om;
 	Color SearchMap[16];
@@ -39,6 +50,9 @@ public:
 	Color LightMap[16];
 	Color NLightMap[16];
 	Animation* anim[2];
+private:
+	TileSet* set;
+	std::vector<unsigned short> frames[2];
 };
 
 }
@@ -34,6 +34,7 @@ TileMap::TileMap(void)
 	XCellCount = 0;
 	YCellCount = 0;
 	LargeMap = !core->HasFeature(GF_SMALL_FOG);
+	doorGridDirty = containerGridDirty = infoPointGridDirty = true;
 }
 
 TileMap::~TileMap(void)
@@ -108,6 +109,9 @@ Door* TileMap::AddDoor(const char *ID, const char* Name, unsigned int Flags,
 	door->SetName( ID );
 	door->SetScriptName( Name );
 	doors.push_back( door );
+	doorNames.Add(door);
+	doorsByID[door->GetGlobalID()] = door;
+	doorGridDirty = true;
 	return door;
 }
 
@@ -119,12 +123,32 @@ Door* TileMap::GetDoor(unsigned int idx) const
 	return doors[idx];
 }
 
-Door* TileMap::GetDoor(const Point &p) const
+void TileMap::UpdateDoorGrid() const
 {
+	if (!doorGridDirty) {
+		return;
+	}
+	// both polygons are indexed, so opening and closing needs no rebuild
+	doorGrid.Reset(XCellCount * 64, YCellCount * 64);
 	for (size_t i = 0; i < doors.size(); i++) {
+		if (doors[i]->open) {
+			doorGrid.Insert(doors[i]->open->BBox, (unsigned int) i);
+		}
+		if (doors[i]->closed) {
+			doorGrid.Insert(doors[i]->closed->BBox, (unsigned int) i);
+		}
+	}
+	doorGridDirty = false;
+}
+
+Door* TileMap::GetDoor(const Point &p) const
+{
+	UpdateDoorGrid();
+	const std::vector<unsigned int> &nearby = doorGrid.Query(p);
+	for (size_t i = 0; i < nearby.size(); i++) {
 		Gem_Polygon *doorpoly;
 
-		Door* door = doors[i];
+		Door* door = doors[nearby[i]];
 		if (door->Flags&DOOR_HIDDEN) {
 			continue;
 		}
@@ -162,11 +186,33 @@ Door* TileMap::GetDoorByPosition(const Point &p) const
 	return NULL;
 }
 
-Door* TileMap::GetDoor(const char* Name) const
+// the indexes only look at the first 32 characters
+template <class T>
+static T* FullNameMatch(T* obj, const char* Name)
+{
+	if (obj && stricmp(obj->GetScriptName(), Name) != 0) {
+		return NULL;
+	}
+	return obj;
+}
+
+template <class T>
+static T* FindByGlobalID(const std::map<ieDword, T*>& index, ieDword objectID)
 {
-	if (!Name) {
+	typename std::map<ieDword, T*>::const_iterator it = index.find(objectID);
+	if (it == index.end()) {
 		return NULL;
 	}
+	return it->second;
+}
+
+Door* TileMap::GetDoor(const char* Name) const
+{
+	Door* door;
+	size_t count = doorNames.Find(Name, door);
+	if (count < 2) {
+		return FullNameMatch(door, Name);
+	}
 	for (size_t i = 0; i < doors.size(); i++) {
 		Door* door = doors[i];
 		if (stricmp( door->GetScriptName(), Name ) == 0)
@@ -175,6 +221,11 @@ Door* TileMap::GetDoor(const char* Name) const
 	return NULL;
 }
 
+Door* TileMap::GetDoorByGlobalID(ieDword objectID) const
+{
+	return FindByGlobalID(doorsByID, objectID);
+}
+
 void TileMap::UpdateDoors()
 {
 	for (size_t i = 0; i < doors.size(); i++) {
@@ -195,6 +246,8 @@ void TileMap::AddOverlay(TileOverlay* overlay)
 		}
 	}
 	overlays.push_back( overlay );
+	// the grids depend on the map size
+	doorGridDirty = containerGridDirty = infoPointGridDirty = true;
 }
 
 void TileMap::AddRainOverlay(TileOverlay* overlay)
@@ -419,6 +472,9 @@ void TileMap::DrawFogOfWar(ieByte* explored_mask, ieByte* visible_mask, Region v
 void TileMap::AddContainer(Container *c)
 {
 	containers.push_back(c);
+	containerNames.Add(c);
+	containersByID[c->GetGlobalID()] = c;
+	containerGridDirty = true;
 }
 
 Container* TileMap::GetContainer(unsigned int idx) const
@@ -431,6 +487,11 @@ Container* TileMap::GetContainer(unsigned int idx) const
 
 Container* TileMap::GetContainer(const char* Name) const
 {
+	Container* container;
+	size_t count = containerNames.Find(Name, container);
+	if (count < 2) {
+		return FullNameMatch(container, Name);
+	}
 	for (size_t i = 0; i < containers.size(); i++) {
 		Container* cn = containers[i];
 		if (stricmp( cn->GetScriptName(), Name ) == 0)
@@ -439,13 +500,32 @@ Container* TileMap::GetContainer(const char* Name) const
 	return NULL;
 }
 
+Container* TileMap::GetContainerByGlobalID(ieDword objectID) const
+{
+	return FindByGlobalID(containersByID, objectID);
+}
+
 //look for a container at position
 //use type = IE_CONTAINER_PILE if you want to find ground piles only
 //in this case, empty piles won't be found!
-Container* TileMap::GetContainer(const Point &position, int type) const
+void TileMap::UpdateContainerGrid() const
 {
+	if (!containerGridDirty) {
+		return;
+	}
+	containerGrid.Reset(XCellCount * 64, YCellCount * 64);
 	for (size_t i = 0; i < containers.size(); i++) {
-		Container* c = containers[i];
+		containerGrid.Insert(containers[i]->outline->BBox, (unsigned int) i);
+	}
+	containerGridDirty = false;
+}
+
+Container* TileMap::GetContainer(const Point &position, int type) const
+{
+	UpdateContainerGrid();
+	const std::vector<unsigned int> &nearby = containerGrid.Query(position);
+	for (size_t i = 0; i < nearby.size(); i++) {
+		Container* c = containers[nearby[i]];
 		if (type!=-1) {
 			if (c->Type!=type) {
 				continue;
@@ -513,6 +593,9 @@ int TileMap::CleanupContainer(Container *container)
 	for (size_t i = 0; i < containers.size(); i++) {
 		if (containers[i]==container) {
 			containers.erase(containers.begin()+i);
+			containerNames.Remove(container);
+			containersByID.erase(container->GetGlobalID());
+			containerGridDirty = true;
 			delete container;
 			return 1;
 		}
@@ -548,14 +631,45 @@ InfoPoint* TileMap::AddInfoPoint(const char* Name, unsigned short Type,
 	ip->outline = outline;
 	//ip->Active = true; //set active on creation
 	infoPoints.push_back( ip );
+	infoPointNames.Add(ip);
+	infoPointsByID[ip->GetGlobalID()] = ip;
+	infoPointGridDirty = true;
 	return ip;
 }
 
 //if detectable is set, then only detectable infopoints will be returned
-InfoPoint* TileMap::GetInfoPoint(const Point &p, bool detectable) const
+void TileMap::UpdateInfoPointGrid() const
 {
+	if (!infoPointGridDirty) {
+		return;
+	}
+	infoPointGrid.Reset(XCellCount * 64, YCellCount * 64);
+	triggerGrid.Reset(XCellCount * 64, YCellCount * 64);
+	std::vector<Region> regions;
 	for (size_t i = 0; i < infoPoints.size(); i++) {
 		InfoPoint* ip = infoPoints[i];
+		infoPointGrid.Insert(ip->outline->BBox, (unsigned int) i);
+		regions.clear();
+		ip->GetTriggerRegions(regions);
+		for (size_t j = 0; j < regions.size(); j++) {
+			triggerGrid.Insert(regions[j], (unsigned int) i);
+		}
+	}
+	infoPointGridDirty = false;
+}
+
+void TileMap::GetTriggerCandidates(const Region &rgn, std::vector<unsigned int> &indexes) const
+{
+	UpdateInfoPointGrid();
+	triggerGrid.Query(rgn, indexes);
+}
+
+InfoPoint* TileMap::GetInfoPoint(const Point &p, bool detectable) const
+{
+	UpdateInfoPointGrid();
+	const std::vector<unsigned int> &nearby = infoPointGrid.Query(p);
+	for (size_t i = 0; i < nearby.size(); i++) {
+		InfoPoint* ip = infoPoints[nearby[i]];
 		//these flags disable any kind of user interaction
 		//scripts can still access an infopoint by name
 		if (ip->Flags&(INFO_DOOR|TRAP_DEACTIVATED) )
@@ -591,6 +705,11 @@ InfoPoint* TileMap::GetInfoPoint(const Point &p, bool detectable) const
 
 InfoPoint* TileMap::GetInfoPoint(const char* Name) const
 {
+	InfoPoint* ip;
+	size_t count = infoPointNames.Find(Name, ip);
+	if (count < 2) {
+		return FullNameMatch(ip, Name);
+	}
 	for (size_t i = 0; i < infoPoints.size(); i++) {
 		InfoPoint* ip = infoPoints[i];
 		if (stricmp( ip->GetScriptName(), Name ) == 0)
@@ -599,6 +718,11 @@ InfoPoint* TileMap::GetInfoPoint(const char* Name) const
 	return NULL;
 }
 
+InfoPoint* TileMap::GetInfoPointByGlobalID(ieDword objectID) const
+{
+	return FindByGlobalID(infoPointsByID, objectID);
+}
+
 InfoPoint* TileMap::GetInfoPoint(unsigned int idx) const
 {
 	if (idx >= infoPoints.size()) {
@@ -24,7 +24,11 @@
 #include "exports.h"
 
 #include "Polygon.h"
+#include "SpatialGrid.h"
 #include "TileOverlay.h"
+#include "Scriptable/ScriptNameIndex.h"
+
+#include <map>
 
 namespace GemRB {
 
@@ -44,7 +48,24 @@ private:
 	std::vector< Container*> containers;
 	std::vector< InfoPoint*> infoPoints;
 	std::vector< TileObject*> tiles;
+	// lookup indexes for the doors, containers and infopoints
+	ScriptNameIndex<Door> doorNames;
+	ScriptNameIndex<Container> containerNames;
+	ScriptNameIndex<InfoPoint> infoPointNames;
+	std::map<ieDword, Door*> doorsByID;
+	std::map<ieDword, Container*> containersByID;
+	std::map<ieDword, InfoPoint*> infoPointsByID;
+	// position lookups, rebuilt on the next use after objects come or go
+	mutable SpatialGrid doorGrid;
+	mutable SpatialGrid containerGrid;
+	mutable SpatialGrid infoPointGrid;
+	mutable SpatialGrid triggerGrid;
+	mutable bool doorGridDirty, containerGridDirty, infoPointGridDirty;
 	bool LargeMap;
+
+	void UpdateDoorGrid() const;
+	void UpdateContainerGrid() const;
+	void UpdateInfoPointGrid() const;
 public:
 	TileMap(void);
 	~TileMap(void);
@@ -58,6 +79,7 @@ public:
 	Door* GetDoorByPosition(const Point &position) const;
 	Door* GetDoor(unsigned int idx) const;
 	Door* GetDoor(const char* Name) const;
+	Door* GetDoorByGlobalID(ieDword objectID) const;
 	size_t GetDoorCount() { return doors.size(); }
 	//update doors for a new overlay
 	void UpdateDoors();
@@ -70,6 +92,7 @@ public:
 	Container* GetContainerByPosition(const Point &position, int type=-1) const;
 	Container* GetContainer(const char* Name) const;
 	Container* GetContainer(unsigned int idx) const;
+	Container* GetContainerByGlobalID(ieDword objectID) const;
 	/* cleans up empty heaps, returns 1 if container removed*/
 	int CleanupContainer(Container *container);
 	size_t GetContainerCount() const { return containers.size(); }
@@ -79,6 +102,10 @@ public:
 	InfoPoint* GetInfoPoint(const Point &position, bool detectable) const;
 	InfoPoint* GetInfoPoint(const char* Name) const;
 	InfoPoint* GetInfoPoint(unsigned int idx) const;
+	InfoPoint* GetInfoPointByGlobalID(ieDword objectID) const;
+	/* collects the indexes of the infopoints actors in the region may
+	 * enter, in increasing order */
+	void GetTriggerCandidates(const Region &rgn, std::vector<unsigned int> &indexes) const;
 	InfoPoint* GetTravelTo(const char* Destination) const;
 	InfoPoint* AdjustNearestTravel(Point &p);
 	size_t GetInfoPointCount() const { return infoPoints.size(); }
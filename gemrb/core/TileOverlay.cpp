@@ -23,7 +23,9 @@
 //#include "Game.h" // needed only for TILE_GREY below
 #include "GlobalTimer.h"
 #include "Interface.h"
+#include "TileSet.h"
 #include "Video.h"
+#include "System/Threading.h"
 
 namespace GemRB {
 
@@ -35,6 +37,8 @@ TileOverlay::TileOverlay(int Width, int Height)
 	h = Height;
 	count = 0;
 	tiles = ( Tile * * ) malloc( w * h * sizeof( Tile * ) );
+	tileset = NULL;
+	prefetchX = prefetchY = -1;
 }
 
 TileOverlay::~TileOverlay(void)
@@ -43,6 +47,13 @@ TileOverlay::~TileOverlay(void)
 		delete( tiles[i] );
 	}
 	free( tiles );
+	delete tileset;
+}
+
+void TileOverlay::SetTileSet(TileSet* set)
+{
+	delete tileset;
+	tileset = set;
 }
 
 void TileOverlay::AddTile(Tile* tile)
@@ -76,10 +87,59 @@ void TileOverlay::BumpViewport(const Region &viewport, Region &vp)
 	}
 }
 
+// one BlitTile call, gathered on the main thread since advancing the
+// tile animations isn't thread safe
+struct TileBlit {
+	Sprite2D* spr;
+	Sprite2D* mask;
+	int x, y;
+	int flags;
+};
+
+// draws a band of whole tile rows; bands never share pixels
+class TileBand : public Task {
+public:
+	TileBand() : blits(NULL), begin(0), end(0) {}
+
+	void Run()
+	{
+		Video* vid = core->GetVideoDriver();
+		for (size_t i = begin; i < end; i++) {
+			const TileBlit& b = (*blits)[i];
+			vid->BlitTile(b.spr, b.mask, b.x, b.y, clip, b.flags);
+		}
+	}
+
+	const std::vector<TileBlit>* blits;
+	size_t begin, end;
+	const Region* clip;
+};
+
+static WorkerPool* tilePool = NULL;
+// frame time statistics of the tile drawing
+static unsigned __int64 drawTime = 0;
+static unsigned int drawFrames = 0;
+
+void TileOverlay::SetDrawThreads(int threads)
+{
+	delete tilePool;
+	tilePool = NULL;
+	if (threads < 0) {
+		threads = Thread::GetCPUCount();
+	}
+	// the main thread draws a band too
+	if (threads > 1) {
+		tilePool = new WorkerPool(threads - 1);
+	}
+	drawTime = 0;
+	drawFrames = 0;
+}
+
 void TileOverlay::Draw(Region viewport, std::vector< TileOverlay*> &overlays, int flags)
 {
 	Video* vid = core->GetVideoDriver();
 	Region vp = vid->GetViewport();
+	unsigned __int64 startTime = GetMicroTicks();
 
 	// if the video's viewport is partially outside of the map, bump it back
 	BumpViewport(viewport, vp);
@@ -89,18 +149,32 @@ void TileOverlay::Draw(Region viewport, std::vector< TileOverlay*> &overlays, in
 	int dx = ( vp.x + vp.w + 63 ) / 64;
 	int dy = ( vp.y + vp.h + 63 ) / 64;
 
+	// the sprites of the last frame are drawn, so they can be freed now
+	TileSet::NewFrame();
+	if (tileset) {
+		tileset->Trim();
+	}
+
+	static std::vector<TileBlit> blits;
+	// index of the first blit of each tile row
+	static std::vector<size_t> rows;
+	blits.clear();
+	rows.clear();
+
 	for (int y = sy; y < dy && y < h; y++) {
+		rows.push_back(blits.size());
 		for (int x = sx; x < dx && x < w; x++) {
 			Tile* tile = tiles[( y* w ) + x];
 
 			//draw door tiles if there are any
-			Animation* anim = tile->anim[tile->tileIndex];
-			if (!anim && tile->tileIndex) {
-				anim = tile->anim[0];
+			int anim = tile->tileIndex;
+			if (!tile->anim[anim] && anim) {
+				anim = 0;
 			}
-			assert(anim);
-			vid->BlitTile( anim->NextFrame(), 0, viewport.x + ( x * 64 ),
-				viewport.y + ( y * 64 ), &viewport, flags );
+			assert(tile->anim[anim]);
+			TileBlit blit = { tile->NextFrame(anim), NULL, viewport.x + ( x * 64 ),
+				viewport.y + ( y * 64 ), flags };
+			blits.push_back(blit);
 			if (!tile->om || tile->tileIndex) {
 				continue;
 			}
@@ -112,28 +186,77 @@ void TileOverlay::Draw(Region viewport, std::vector< TileOverlay*> &overlays, in
 				if (ov && ov->count > 0) {
 					Tile *ovtile = ov->tiles[0]; //allow only 1x1 tiles now
 					if (tile->om & mask) {
+						blit.spr = ovtile->NextFrame(0);
 						if (RedrawTile) {
-							vid->BlitTile( ovtile->anim[0]->NextFrame(),
-						                   tile->anim[0]->NextFrame(),
-							               viewport.x + ( x * 64 ),
-							               viewport.y + ( y * 64 ),
-							               &viewport, flags );
+							blit.mask = tile->NextFrame(0);
+							blit.flags = flags;
 						} else {
-							Sprite2D* mask = 0;
+							blit.mask = NULL;
 							if (tile->anim[1])
-								mask = tile->anim[1]->NextFrame();
-							vid->BlitTile( ovtile->anim[0]->NextFrame(),
-						                   mask,
-							               viewport.x + ( x * 64 ),
-							               viewport.y + ( y * 64 ),
-							               &viewport, TILE_HALFTRANS | flags );
+								blit.mask = tile->NextFrame(1);
+							blit.flags = TILE_HALFTRANS | flags;
 						}
+						blits.push_back(blit);
 					}
 				}
 				mask<<=1;
 			}
 		}
 	}
+	rows.push_back(blits.size());
+
+	// decode the tiles just outside of the view ahead, when it moves
+	if (tileset && (sx != prefetchX || sy != prefetchY)) {
+		prefetchX = sx;
+		prefetchY = sy;
+		static std::vector<unsigned short> indexes;
+		indexes.clear();
+		for (int y = sy - 2; y < dy + 2; y++) {
+			if (y < 0 || y >= h) continue;
+			for (int x = sx - 2; x < dx + 2; x++) {
+				if (x < 0 || x >= w) continue;
+				if (y >= sy && y < dy && x >= sx && x < dx) continue;
+				tiles[y * w + x]->GetTileIndexes(indexes);
+			}
+		}
+		tileset->Prefetch(indexes);
+	}
+
+	// split the rows into one band per thread
+	int bandCount = 1;
+	if (tilePool && vid->SupportsConcurrentTiles()) {
+		bandCount = tilePool->GetThreadCount() + 1;
+	}
+	int rowCount = (int) rows.size() - 1;
+	if (bandCount > rowCount) {
+		bandCount = rowCount;
+	}
+
+	static std::vector<TileBand> bands;
+	bands.resize(bandCount);
+	for (int i = 0; i < bandCount; i++) {
+		bands[i].blits = &blits;
+		bands[i].begin = rows[i * rowCount / bandCount];
+		bands[i].end = rows[(i + 1) * rowCount / bandCount];
+		bands[i].clip = &viewport;
+		if (i) {
+			tilePool->Submit(&bands[i]);
+		}
+	}
+	if (bandCount) {
+		bands[0].Run();
+	}
+	if (bandCount > 1) {
+		tilePool->Wait();
+	}
+
+	drawTime += GetMicroTicks() - startTime;
+	if (++drawFrames == 500) {
+		Log(DEBUG, "TileOverlay", "Drawing %dx%d tiles took %.3f ms per frame on %d thread(s)",
+			dx - sx, dy - sy, drawTime / 1000.0 / drawFrames, tilePool ? tilePool->GetThreadCount() + 1 : 1);
+		drawTime = 0;
+		drawFrames = 0;
+	}
 }
 
 }
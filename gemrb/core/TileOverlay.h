@@ -31,18 +31,29 @@ namespace GemRB {
 
 extern bool RedrawTile;
 
+class TileSet;
+
 class GEM_EXPORT TileOverlay {
 public:
 	int w, h;
 	//std::vector<Tile*> tiles;
 	Tile** tiles;
 	int count;
+private:
+	TileSet* tileset;
+	// top left tile of the last prefetch request
+	int prefetchX, prefetchY;
 public:
 	TileOverlay(int Width, int Height);
 	~TileOverlay(void);
 	void AddTile(Tile* tile);
+	/** Sets the set the tiles are decoded from, it is freed with the overlay */
+	void SetTileSet(TileSet* set);
 	void Draw(Region viewport, std::vector< TileOverlay*> &overlays, int flags);
 	void BumpViewport(const Region &viewport, Region &vp);
+
+	/** Sets how many threads draw the tiles, negative picks one per CPU. */
+	static void SetDrawThreads(int threads);
 };
 
 }
@@ -0,0 +1,185 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2016 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "TileSet.h"
+
+#include "Interface.h"
+#include "Sprite2D.h"
+#include "Tile.h"
+#include "Video.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace GemRB {
+
+unsigned int TileSet::currentFrame = 0;
+// a 64x64 tile takes about 5KB, so this is ~10MB per tileset
+size_t TileSet::budget = 2048;
+
+static WorkerPool* prefetchPool = NULL;
+
+class TileSet::PrefetchTask : public Task {
+public:
+	PrefetchTask(TileSet* set) : set(set), pending(false) {}
+
+	void Run()
+	{
+		// one tile at a time, so the drawing thread isn't held up for long
+		for (size_t i = 0; i < indexes.size(); i++) {
+			MutexLock l(set->mutex);
+			set->Decode(indexes[i]);
+		}
+		MutexLock l(set->mutex);
+		pending = false;
+	}
+
+	TileSet* set;
+	std::vector<unsigned short> indexes;
+	bool pending;
+};
+
+TileSet::TileSet(TileSetMgr* source)
+	: source(source), decodedCount(0), frame(currentFrame),
+	decodes(0), evictions(0)
+{
+	prefetch = new PrefetchTask(this);
+}
+
+TileSet::~TileSet()
+{
+	bool pending;
+	{
+		MutexLock l(mutex);
+		pending = prefetch->pending;
+	}
+	if (pending) {
+		prefetchPool->Wait();
+	}
+	delete prefetch;
+
+	for (size_t i = 0; i < tiles.size(); i++) {
+		Sprite2D::FreeSprite(tiles[i]);
+	}
+	Log(DEBUG, "TileSet", "Decoded %u tiles (%u evicted) of %u referenced",
+		decodes, evictions, (unsigned int) tiles.size());
+}
+
+Tile* TileSet::CreateTile(const unsigned short* indexes, int count,
+	const unsigned short* secondary)
+{
+	return new Tile(this, indexes, count, secondary);
+}
+
+Sprite2D* TileSet::GetTile(unsigned short index)
+{
+	MutexLock l(mutex);
+	frame = currentFrame;
+	return Decode(index);
+}
+
+// the mutex has to be held by the caller
+Sprite2D* TileSet::Decode(unsigned short index)
+{
+	if (index >= tiles.size()) {
+		tiles.resize(index + 1, NULL);
+		lastUsed.resize(index + 1, 0);
+	}
+	if (!tiles[index]) {
+		tiles[index] = source->GetTile(index);
+		decodedCount++;
+		decodes++;
+	}
+	lastUsed[index] = frame;
+	return tiles[index];
+}
+
+void TileSet::Prefetch(const std::vector<unsigned short>& indexes)
+{
+	// sprites have to be created on the prefetch thread
+	if (!prefetchPool || !core->GetVideoDriver()->SupportsConcurrentSprites()) {
+		return;
+	}
+
+	{
+		MutexLock l(mutex);
+		if (prefetch->pending) {
+			// still busy with the last request
+			return;
+		}
+		prefetch->indexes.clear();
+		for (size_t i = 0; i < indexes.size(); i++) {
+			unsigned short index = indexes[i];
+			if (index >= tiles.size() || !tiles[index]) {
+				prefetch->indexes.push_back(index);
+			}
+		}
+		if (prefetch->indexes.empty()) {
+			return;
+		}
+		prefetch->pending = true;
+	}
+	prefetchPool->Submit(prefetch);
+}
+
+void TileSet::Trim()
+{
+	MutexLock l(mutex);
+	frame = currentFrame;
+	if (!budget || decodedCount <= budget) {
+		return;
+	}
+
+	// go down to three quarters of the budget, so this doesn't run every frame
+	std::vector<std::pair<unsigned int, unsigned short> > used;
+	used.reserve(decodedCount);
+	for (size_t i = 0; i < tiles.size(); i++) {
+		if (tiles[i]) {
+			used.push_back(std::make_pair(lastUsed[i], (unsigned short) i));
+		}
+	}
+	size_t drop = decodedCount - budget * 3 / 4;
+	std::nth_element(used.begin(), used.begin() + drop, used.end());
+	for (size_t i = 0; i < drop; i++) {
+		// never throw away what is on screen, even if the budget is too small
+		if (used[i].first + 1 >= frame) {
+			continue;
+		}
+		Sprite2D::FreeSprite(tiles[used[i].second]);
+		decodedCount--;
+		evictions++;
+	}
+}
+
+void TileSet::SetBudget(int tiles)
+{
+	budget = tiles > 0 ? tiles : 0;
+}
+
+void TileSet::SetPrefetch(int enable)
+{
+	// pending tasks are still run before the thread quits
+	delete prefetchPool;
+	prefetchPool = NULL;
+	if (enable) {
+		prefetchPool = new WorkerPool(1);
+	}
+}
+
+}
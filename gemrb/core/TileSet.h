@@ -0,0 +1,96 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2016 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/**
+ * @file TileSet.h
+ * Declares TileSet, the store of lazily decoded area tiles
+ * @author The GemRB Project
+ */
+
+#ifndef TILESET_H
+#define TILESET_H
+
+#include "exports.h"
+
+#include "Holder.h"
+#include "TileSetMgr.h"
+#include "System/Threading.h"
+
+#include <vector>
+
+namespace GemRB {
+
+class Sprite2D;
+
+/**
+ * @class TileSet
+ * Decodes the tiles of a tileset when they are first drawn and frees the
+ * least recently drawn ones once there are more than the budget.
+ * Tiles around the viewport can be decoded ahead on a background thread.
+ */
+
+class GEM_EXPORT TileSet {
+public:
+	TileSet(TileSetMgr* source);
+	~TileSet();
+
+	/** Creates a tile with frames from this set, decoded on first use */
+	Tile* CreateTile(const unsigned short* indexes, int count,
+		const unsigned short* secondary = NULL);
+	/** Returns a decoded tile, the sprite stays valid until the next Trim() */
+	Sprite2D* GetTile(unsigned short index);
+	/** Decodes the given tiles in the background, if prefetching is enabled */
+	void Prefetch(const std::vector<unsigned short>& indexes);
+	/** Frees the least recently used tiles while over the budget,
+	 * call it only between frames */
+	void Trim();
+
+	/** Starts a new frame for the least recently used bookkeeping */
+	static void NewFrame() { currentFrame++; }
+	/** Sets how many decoded tiles each set may keep, 0 for no limit */
+	static void SetBudget(int tiles);
+	/** Enables decoding the tiles around the viewport on a background thread */
+	static void SetPrefetch(int enable);
+
+private:
+	class PrefetchTask;
+	friend class PrefetchTask;
+
+	Sprite2D* Decode(unsigned short index);
+
+	Holder<TileSetMgr> source;
+	std::vector<Sprite2D*> tiles;
+	std::vector<unsigned int> lastUsed;
+	size_t decodedCount;
+	// currentFrame as seen by the drawing thread
+	unsigned int frame;
+	unsigned int decodes, evictions;
+	Mutex mutex;
+	PrefetchTask* prefetch;
+
+	static unsigned int currentFrame;
+	static size_t budget;
+
+	TileSet(const TileSet&);
+	TileSet& operator=(const TileSet&);
+};
+
+}
+
+#endif
@@ -34,6 +34,8 @@ public:
 	virtual bool Open(DataStream* stream) = 0;
 	virtual Tile* GetTile(unsigned short* indexes, int count,
 		unsigned short* secondary = NULL) = 0;
+	/** Decodes a single tile, see TileSet */
+	virtual Sprite2D* GetTile(int index) = 0;
 };
 
 }
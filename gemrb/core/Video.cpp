@@ -54,6 +54,7 @@ Video::Video(void)
 	// boring inits just to be extra clean
 	xCorr = yCorr = width = height = bpp = 0;
 	fullscreen = false;
+	dirtyScreen = true;
 	subtitlefont = NULL;
 	subtitlepal = NULL;
 }
@@ -73,6 +74,69 @@ Region Video::ClippedDrawingRect(const Region& target, const Region* clip) const
 	return r;
 }
 
+// more rectangles than this are not worth tracking separately
+#define MAX_DIRTY_REGIONS 16
+
+static bool RegionContains(const Region& outer, const Region& inner)
+{
+	return inner.x >= outer.x && inner.y >= outer.y
+		&& inner.x + inner.w <= outer.x + outer.w
+		&& inner.y + inner.h <= outer.y + outer.h;
+}
+
+void Video::InvalidateRegion(const Region& rgn)
+{
+	if (dirtyScreen) {
+		return;
+	}
+	Region r = rgn.Intersect(Region(0, 0, width, height));
+	if (r.w <= 0 || r.h <= 0) {
+		return;
+	}
+
+	// overlapping rectangles are merged, so the list never uploads a pixel twice
+	std::vector<Region>::iterator it = dirtyRegions.begin();
+	while (it != dirtyRegions.end()) {
+		if (RegionContains(*it, r)) {
+			return;
+		}
+		if (it->IntersectsRegion(r)) {
+			std::vector<Region> pair;
+			pair.push_back(*it);
+			pair.push_back(r);
+			r = Region::RegionEnclosingRegions(pair);
+			dirtyRegions.erase(it);
+			// the bigger rectangle may now overlap the ones already checked
+			it = dirtyRegions.begin();
+			continue;
+		}
+		++it;
+	}
+
+	if (dirtyRegions.size() >= MAX_DIRTY_REGIONS) {
+		dirtyRegions.push_back(r);
+		r = Region::RegionEnclosingRegions(dirtyRegions);
+		dirtyRegions.clear();
+	}
+	if (r.w * r.h * 4 >= width * height * 3) {
+		InvalidateScreen();
+		return;
+	}
+	dirtyRegions.push_back(r);
+}
+
+void Video::InvalidateScreen()
+{
+	dirtyRegions.clear();
+	dirtyScreen = true;
+}
+
+void Video::ClearDirtyRegions()
+{
+	dirtyRegions.clear();
+	dirtyScreen = false;
+}
+
 void Video::SetScreenClip(const Region* clip)
 {
 	screenClip = Region(0,0, width, height);
@@ -33,6 +33,8 @@
 #include "Polygon.h"
 #include "ScriptedAnimation.h"
 
+#include <vector>
+
 namespace GemRB {
 
 class EventMgr;
@@ -108,8 +110,13 @@ protected:
 	Palette *subtitlepal;
 	Region subtitleregion;
 	Color fadeColor;
+	// parts of the back buffer changed since the last SwapBuffers
+	std::vector<Region> dirtyRegions;
+	bool dirtyScreen;
 protected:
 	Region ClippedDrawingRect(const Region& target, const Region* clip = NULL) const;
+	/** Forgets the changes, called once they were presented */
+	void ClearDirtyRegions();
 public:
 	Video(void);
 	virtual ~Video(void) {};
@@ -140,6 +147,11 @@ public:
 	virtual Sprite2D* CreatePalettedSprite(int w, int h, int bpp, void* pixels,
 										   Color* palette, bool cK = false, int index = 0) = 0;
 	virtual bool SupportsBAMSprites() { return false; }
+	/** BlitTile may be called from several threads at once, as long as
+	 * the tiles don't overlap */
+	virtual bool SupportsConcurrentTiles() { return false; }
+	/** The Create*Sprite functions may be called from other threads */
+	virtual bool SupportsConcurrentSprites() { return false; }
 
 	virtual void BlitTile(const Sprite2D* spr, const Sprite2D* mask, int x, int y,
 						  const Region* clip, unsigned int flags) = 0;
@@ -154,6 +166,16 @@ public:
 		unsigned int flags, Color tint,
 		SpriteCover* cover, Palette *palette = NULL,
 		const Region* clip = NULL, bool anchor = false) = 0;
+	/** Marks a part of the screen as changed, so it gets presented with the
+	 * next SwapBuffers. Anything drawing outside of Window::DrawWindow
+	 * has to report what it touched. */
+	void InvalidateRegion(const Region& rgn);
+	/** Marks the whole screen as changed */
+	void InvalidateScreen();
+	/** Called before something is drawn over the finished frame during
+	 * SwapBuffers (tooltips). Drivers that have to take it away again
+	 * can save the background here. */
+	virtual void PrepareOverlay(const Region& rgn) { InvalidateRegion(rgn); }
 	/** Return GemRB window screenshot.
 	 * It's generated from the momentary back buffer */
 	virtual Sprite2D* GetScreenshot( Region r ) = 0;
@@ -234,7 +256,7 @@ public:
 	void SetMouseGrayed(bool grayed);
 	bool GetFullscreenMode() const;
 	/** Sets the mouse cursor sprite to be used for mouseUp, mouseDown, and mouseDrag. See VID_CUR_* defines. */
-	void SetCursor(Sprite2D* cur, enum CursorType curIdx);
+	virtual void SetCursor(Sprite2D* cur, enum CursorType curIdx);
 
 	/** Scales down a sprite by a ratio */
 	Sprite2D* SpriteScaleDown( const Sprite2D* sprite, unsigned int ratio );
@@ -209,6 +209,21 @@ inline unsigned long GetTickCount()
 }
 #endif
 
+/** Microsecond timer for profiling, only differences are meaningful. */
+inline unsigned __int64 GetMicroTicks()
+{
+#ifdef WIN32
+	LARGE_INTEGER freq, now;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&now);
+	return (unsigned __int64) ((now.QuadPart / freq.QuadPart) * 1000000 + (now.QuadPart % freq.QuadPart) * 1000000 / freq.QuadPart);
+#else
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (unsigned __int64) tv.tv_sec * 1000000 + tv.tv_usec;
+#endif
+}
+
 inline bool valid_number(const char* string, long& val)
 {
 	char* endpr;
@@ -87,6 +87,7 @@ bool p2DAImporter::Open(DataStream* str)
 			colHead = false;
 			char* str = strtok( line, " " );
 			while (str != NULL) {
+				AddName( colIndex, str, ( int ) colNames.size() );
 				colNames.push_back( str );
 				str = strtok( NULL, " " );
 			}
@@ -94,6 +95,7 @@ bool p2DAImporter::Open(DataStream* str)
 			char* str = strtok( line, " " );
 			if (str == NULL)
 				continue;
+			AddName( rowIndex, str, ( int ) rowNames.size() );
 			rowNames.push_back( str );
 			RowEntry r;
 			rows.push_back( r );
@@ -25,7 +25,10 @@
 
 #include "globals.h"
 
+#include <cctype>
 #include <cstring>
+#include <map>
+#include <string>
 #include <vector>
 
 namespace GemRB {
@@ -38,7 +41,34 @@ private:
 	std::vector< char*> rowNames;
 	std::vector< char*> ptrs;
 	std::vector< RowEntry> rows;
+	// first row/column by its lowercased name
+	typedef std::map<std::string, int> NameIndex;
+	NameIndex rowIndex;
+	NameIndex colIndex;
 	char defVal[32];
+
+	static void AddName(NameIndex& index, const char* name, int pos)
+	{
+		index.insert(std::make_pair(Lowercase(name), pos));
+	}
+
+	static int FindName(const NameIndex& index, const char* name)
+	{
+		NameIndex::const_iterator it = index.find(Lowercase(name));
+		if (it == index.end()) {
+			return -1;
+		}
+		return it->second;
+	}
+
+	static std::string Lowercase(const char* name)
+	{
+		std::string key = name;
+		for (size_t i = 0; i < key.length(); i++) {
+			key[i] = (char) tolower((unsigned char) key[i]);
+		}
+		return key;
+	}
 public:
 	p2DAImporter(void);
 	~p2DAImporter(void);
@@ -105,22 +135,12 @@ public:
 
 	inline int GetRowIndex(const char* string) const
 	{
-		for (unsigned int index = 0; index < rowNames.size(); index++) {
-			if (stricmp( rowNames[index], string ) == 0) {
-				return (int) index;
-			}
-		}
-		return -1;
+		return FindName(rowIndex, string);
 	}
 
 	inline int GetColumnIndex(const char* string) const
 	{
-		for (unsigned int index = 0; index < colNames.size(); index++) {
-			if (stricmp( colNames[index], string ) == 0) {
-				return (int) index;
-			}
-		}
-		return -1;
+		return FindName(colIndex, string);
 	}
 
 	inline const char* GetColumnName(unsigned int index) const
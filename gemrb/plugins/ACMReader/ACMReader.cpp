@@ -76,6 +76,13 @@ bool ACMReader::Open(DataStream* stream)
 	if (!decoder || !decoder->init_decoder()) {
 		return false;
 	}
+#ifdef VALIDATE_ACM
+	reference = new CSubbandDecoder( levels );
+	check = (int *) malloc(sizeof(int)*block_size);
+	if (!reference->init_decoder() || !check) {
+		return false;
+	}
+#endif
 	return true;
 }
 int ACMReader::make_new_samples()
@@ -84,7 +91,21 @@ int ACMReader::make_new_samples()
 		return 0;
 	}
 
+#ifdef VALIDATE_ACM
+	memcpy( check, block, sizeof(int)*block_size );
+	unsigned long start = GetMicroTicks();
+	reference->decode_reference( check, subblocks );
+	reference_time += GetMicroTicks() - start;
+	start = GetMicroTicks();
+#endif
 	decoder->decode_data( block, subblocks );
+#ifdef VALIDATE_ACM
+	decode_time += GetMicroTicks() - start;
+	if (memcmp( check, block, sizeof(int)*block_size )) {
+		Log(ERROR, "ACMReader", "Block %d differs from the reference decoder!", checked_blocks);
+	}
+	checked_blocks++;
+#endif
 	values = block;
 	samples_ready = ( block_size > samples_left ) ? samples_left : block_size;
 	samples_left -= samples_ready;
@@ -102,11 +123,16 @@ int ACMReader::read_samples(short* buffer, int count)
 			if (!make_new_samples())
 				break;
 		}
-		*buffer = ( short ) ( ( *values ) >> levels );
-		values++;
-		buffer++;
-		res += 1;
-		samples_ready--;
+		int n = count - res;
+		if (n > samples_ready)
+			n = samples_ready;
+		for (int i = 0; i < n; i++) {
+			buffer[i] = ( short ) ( values[i] >> levels );
+		}
+		values += n;
+		buffer += n;
+		res += n;
+		samples_ready -= n;
 	}
 	return res;
 }
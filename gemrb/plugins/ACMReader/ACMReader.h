@@ -43,6 +43,12 @@ private:
 	int samples_ready;
 	CValueUnpacker* unpacker; // ACM-stream unpacker
 	CSubbandDecoder* decoder; // IP's subband decoder
+#ifdef VALIDATE_ACM
+	CSubbandDecoder* reference;
+	int* check;
+	int checked_blocks;
+	unsigned long decode_time, reference_time;
+#endif
 
 	int make_new_samples();
 public:
@@ -50,6 +56,12 @@ public:
 		: samples_left(0), levels(0), subblocks(0), block_size(0), block(NULL), values(NULL),
 		samples_ready( 0 ), unpacker( NULL ), decoder( NULL )
 	{
+#ifdef VALIDATE_ACM
+		reference = NULL;
+		check = NULL;
+		checked_blocks = 0;
+		decode_time = reference_time = 0;
+#endif
 	}
 	virtual ~ACMReader()
 	{
@@ -59,13 +71,31 @@ public:
 	{
 		if (block) {
 			free(block);
+			block = NULL;
 		}
 		if (unpacker) {
 			delete unpacker;
+			unpacker = NULL;
 		}
 		if (decoder) {
 			delete decoder;
+			decoder = NULL;
 		}
+#ifdef VALIDATE_ACM
+		if (checked_blocks) {
+			// both are in samples per microsecond, so millions per second
+			Log(DEBUG, "ACMReader", "Decoded %d blocks of %d samples: %.2f Msamples/s, reference %.2f Msamples/s",
+				checked_blocks, block_size,
+				(double) checked_blocks * block_size / (decode_time ? decode_time : 1),
+				(double) checked_blocks * block_size / (reference_time ? reference_time : 1));
+			checked_blocks = 0;
+			decode_time = reference_time = 0;
+		}
+		delete reference;
+		reference = NULL;
+		free(check);
+		check = NULL;
+#endif
 	}
 
 	bool Open(DataStream* stream);
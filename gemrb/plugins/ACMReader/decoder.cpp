@@ -22,6 +22,11 @@
 
 #include <cstdlib>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
 int CSubbandDecoder::init_decoder()
 {
 	int memory_size = ( levels == 0 ) ? 0 : ( 3 * ( block_size >> 1 ) - 2 );
@@ -29,15 +34,131 @@ int CSubbandDecoder::init_decoder()
 		memory_buffer = ( int * ) calloc( memory_size, sizeof( int ) );
 		if (!memory_buffer)
 			return 0;
+		history = ( int * ) malloc( block_size * sizeof( int ) );
+		if (!history)
+			return 0;
 	}
 	return 1;
 }
+
+// The subband transform runs down every column of the block, each value
+// depending on the two values above it (the last two rows of the previous
+// block for the first ones). Going over wide subbands row by row instead
+// makes the columns independent lanes. The memory keeps the last two rows
+// of every level one after the other, the first level as shorts.
 void CSubbandDecoder::decode_data(int* buffer, int blocks)
 {
 	if (!levels) {
 		return;
 	} // no levels - no work
 
+	int* buff_ptr = buffer, * mem_ptr = memory_buffer;
+	int sb_size = block_size >> 1; // current subband size
+	int i;
+
+	blocks <<= 1;
+	short* short_mem = ( short * ) mem_ptr;
+	for (i = 0; i < sb_size * 2; i++) {
+		history[i] = short_mem[i];
+	}
+	filter(history, buff_ptr, sb_size, blocks);
+	for (i = 0; i < sb_size * 2; i++) {
+		short_mem[i] = ( short ) history[i];
+	}
+	mem_ptr += sb_size;
+
+	for (i = 0; i < blocks; i++)
+		buff_ptr[i * sb_size]++;
+
+	sb_size >>= 1;
+	blocks <<= 1;
+
+	while (sb_size != 0) {
+		filter( mem_ptr, buff_ptr, sb_size, blocks );
+		mem_ptr += sb_size << 1;
+		sb_size >>= 1;
+		blocks <<= 1;
+	}
+}
+
+// rows always come in pairs, the first of a pair is the sum and the second
+// the difference filter
+void CSubbandDecoder::filter(int* memory, int* buffer, int sb_size, int rows)
+{
+	int* prev_2 = memory, * prev_1 = memory + sb_size;
+	int i;
+
+#ifdef SIMD_SSE2
+	if (sb_size < 4) {
+#endif
+		// too narrow for the vector version, walk the columns
+		for (i = 0; i < sb_size; i++) {
+			int db_0 = prev_2[i], db_1 = prev_1[i];
+			int* buff_ptr = buffer + i;
+			int row = 0;
+			for (; row + 4 <= rows; row += 4) {
+				int row_0 = buff_ptr[0];
+				int row_1 = buff_ptr[sb_size];
+				int row_2 = buff_ptr[sb_size * 2];
+				int row_3 = buff_ptr[sb_size * 3];
+				buff_ptr[0] = db_0 + 2 * db_1 + row_0;
+				buff_ptr[sb_size] = -db_1 + 2 * row_0 - row_1;
+				buff_ptr[sb_size * 2] = row_0 + 2 * row_1 + row_2;
+				buff_ptr[sb_size * 3] = -row_1 + 2 * row_2 - row_3;
+				buff_ptr += sb_size * 4;
+				db_0 = row_2;
+				db_1 = row_3;
+			}
+			if (row < rows) {
+				int row_0 = buff_ptr[0];
+				int row_1 = buff_ptr[sb_size];
+				buff_ptr[0] = db_0 + 2 * db_1 + row_0;
+				buff_ptr[sb_size] = -db_1 + 2 * row_0 - row_1;
+				db_0 = row_0;
+				db_1 = row_1;
+			}
+			prev_2[i] = db_0;
+			prev_1[i] = db_1;
+		}
+#ifdef SIMD_SSE2
+		return;
+	}
+
+	for (int row = 0; row < rows; row += 2) {
+		int* row_0 = buffer + row * sb_size;
+		int* row_1 = row_0 + sb_size;
+		for (i = 0; i + 4 <= sb_size; i += 4) {
+			__m128i r0 = _mm_loadu_si128( ( __m128i * ) ( row_0 + i ) );
+			__m128i r1 = _mm_loadu_si128( ( __m128i * ) ( row_1 + i ) );
+			__m128i p2 = _mm_loadu_si128( ( __m128i * ) ( prev_2 + i ) );
+			__m128i p1 = _mm_loadu_si128( ( __m128i * ) ( prev_1 + i ) );
+			__m128i sum = _mm_add_epi32( _mm_add_epi32( p2, r0 ), _mm_slli_epi32( p1, 1 ) );
+			__m128i diff = _mm_sub_epi32( _mm_slli_epi32( r0, 1 ), _mm_add_epi32( p1, r1 ) );
+			_mm_storeu_si128( ( __m128i * ) ( row_0 + i ), sum );
+			_mm_storeu_si128( ( __m128i * ) ( row_1 + i ), diff );
+			_mm_storeu_si128( ( __m128i * ) ( prev_2 + i ), r0 );
+			_mm_storeu_si128( ( __m128i * ) ( prev_1 + i ), r1 );
+		}
+		for (; i < sb_size; i++) {
+			int r0 = row_0[i];
+			int r1 = row_1[i];
+			row_0[i] = prev_2[i] + 2 * prev_1[i] + r0;
+			row_1[i] = -prev_1[i] + 2 * r0 - r1;
+			prev_2[i] = r0;
+			prev_1[i] = r1;
+		}
+	}
+#endif
+}
+
+#ifdef VALIDATE_ACM
+// the original column by column transform, kept to check the one above
+void CSubbandDecoder::decode_reference(int* buffer, int blocks)
+{
+	if (!levels) {
+		return;
+	} // no levels - no work
+
 	int* buff_ptr = buffer, * mem_ptr = memory_buffer;
 	int sb_size = block_size >> 1; // current subband size
 
@@ -175,3 +296,4 @@ void CSubbandDecoder::sub_4d420c(int* memory, int* buffer, int sb_size,
 		}
 	}
 }
+#endif
@@ -26,15 +26,26 @@
 #include <iostream>
 #endif
 
+// For debugging:
+// decode every block with the original transform too and compare,
+// logging how long both took
+//#define VALIDATE_ACM
+
 class CSubbandDecoder {
 private:
 	int levels, block_size;
 	int* memory_buffer;
+	// the first level's memory while it is decoded
+	int* history;
+	void filter(int* memory, int* buffer, int sb_size, int rows);
+#ifdef VALIDATE_ACM
 	void sub_4d3fcc(short* memory, int* buffer, int sb_size, int blocks);
 	void sub_4d420c(int* memory, int* buffer, int sb_size, int blocks);
+#endif
 public:
 	CSubbandDecoder(int lev_cnt)
-		: levels( lev_cnt ), block_size( 1 << lev_cnt ), memory_buffer( NULL )
+		: levels( lev_cnt ), block_size( 1 << lev_cnt ), memory_buffer( NULL ),
+		history( NULL )
 	{
 	}
 	virtual ~CSubbandDecoder()
@@ -42,10 +53,16 @@ public:
 		if (memory_buffer) {
 			free( memory_buffer );
 		}
+		if (history) {
+			free( history );
+		}
 	}
 
 	int init_decoder();
 	void decode_data(int* buffer, int blocks);
+#ifdef VALIDATE_ACM
+	void decode_reference(int* buffer, int blocks);
+#endif
 };
 
 #endif
@@ -82,9 +82,15 @@ FillerProc Fillers[32] = {
 	& CValueUnpacker::return0, & CValueUnpacker::return0
 };
 
+// tops next_bits up to more than 24 bits at once, so most requests find
+// their bits ready. The extra bits are above the requested ones and all
+// the callers mask or test only those.
 inline void CValueUnpacker::prepare_bits(int bits)
 {
-	while (bits > avail_bits) {
+	if (bits <= avail_bits) {
+		return;
+	}
+	while (avail_bits <= 24) {
 		unsigned char one_byte;
 		if (buffer_bit_offset == UNPACKER_BUFFER_SIZE) {
 			unsigned long remains = stream->Remains();
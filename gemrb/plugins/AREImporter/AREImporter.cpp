@@ -359,6 +359,35 @@ inline ieDword FixIWD2DoorFlags(ieDword Flags, bool reverse)
 	return Flags = (Flags & ~maskOff) | maskOn;
 }
 
+//queue the files the area needs, so they are read while the tile map
+//and the rest of the area are being set up
+void AREImporter::PrefetchResources(const char *ResRef)
+{
+	gamedata->Prefetch(WEDResRef, IE_WED_CLASS_ID);
+
+	if (Script[0]) {
+		gamedata->Prefetch(Script, IE_BCS_CLASS_ID);
+	} else if (core->HasFeature(GF_FORCE_AREA_SCRIPT)) {
+		gamedata->Prefetch(ResRef, IE_BCS_CLASS_ID);
+	}
+
+	for (unsigned int i = 0; i < ActorCount; i++) {
+		ieDword Flags, CreOffset;
+		ieResRef CreResRef;
+
+		str->Seek( ActorOffset + i * 0x110 + 0x28, GEM_STREAM_START );
+		str->ReadDword( &Flags );
+		str->Seek( ActorOffset + i * 0x110 + 0x80, GEM_STREAM_START );
+		str->ReadResRef( CreResRef );
+		str->ReadDword( &CreOffset );
+		//embedded creatures are already here
+		if (CreOffset != 0 && !(Flags&1) ) {
+			continue;
+		}
+		gamedata->Prefetch(CreResRef, IE_CRE_CLASS_ID);
+	}
+}
+
 Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 {
 	unsigned int i,x;
@@ -398,6 +427,8 @@ Map* AREImporter::GetMap(const char *ResRef, bool day_or_night)
 		map->SetTrackString((ieStrRef) -1, false, 0);
 	}
 
+	PrefetchResources(ResRef);
+
 	if (!core->IsAvailable( IE_WED_CLASS_ID )) {
 		Log(ERROR, "AREImporter", "No tile map manager available.");
 		delete map;
@@ -41,6 +41,8 @@
 #include "Variables.h"
 #include "Video.h"
 
+#include "System/Threading.h"
+
 #include <cassert>
 #include <cstdio>
 
@@ -48,12 +50,42 @@
 #include <unistd.h>
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// For debugging:
+// check every SSE2 idct against the scalar version
+//#define VALIDATE_SIMD
+// decode as fast as possible without showing the frames and log the speed
+//#define BENCHMARK_BINK
+
 using namespace GemRB;
 
 static int g_truecolor;
 static ieDword *cbAtFrame = NULL;
 static ieDword *strRef = NULL;
 
+namespace GemRB {
+
+// decodes a frame's audio while the main thread does the video
+class BinkAudioTask : public Task {
+public:
+	BinkAudioTask(BIKPlayer* player) : player(player), data(NULL), size(0) {}
+
+	void Run()
+	{
+		player->DecodeAudioFrame(data, size);
+	}
+
+	BIKPlayer* player;
+	void* data;
+	int size;
+};
+
+}
+
 static const int ff_wma_critical_freqs[25] = {
 	100,   200,  300, 400,   510,  630,  770,    920,
 	1080, 1270, 1480, 1720, 2000, 2320, 2700,   3150,
@@ -65,6 +97,11 @@ BIKPlayer::BIKPlayer(void)
 {
 	video = core->GetVideoDriver();
 	inbuff = NULL;
+	s_samples = NULL;
+	s_samples_size = 0;
+	decode_pool = NULL;
+	audio_task = NULL;
+	decoding = NULL;
 	maxRow = 0;
 	rowCount = 0;
 	frameCount = 0;
@@ -218,8 +255,23 @@ int BIKPlayer::Play()
 	}
 	//Start Movie Playback
 	frameCount = 0;
+	decode_time = 0;
+	decoded_frames = 0;
+	// the main thread decodes too
+	int threads = decodeThreads < 0 ? Thread::GetCPUCount() : decodeThreads;
+	decode_pool = new WorkerPool(threads > 1 ? threads - 1 : 0);
+	audio_task = new BinkAudioTask(this);
 	int ret = doPlay( );
 
+	if (decoded_frames) {
+		Log(DEBUG, "BIKPlayer", "Decoding took %.3f ms per frame on %d thread(s)",
+			decode_time / 1000.0 / decoded_frames, decode_pool->GetThreadCount() + 1);
+	}
+	delete decode_pool;
+	decode_pool = NULL;
+	delete audio_task;
+	audio_task = NULL;
+	dct_jobs.clear();
 	if (s_stream > -1)
 		EndAudio();
 	EndVideo();
@@ -227,93 +279,71 @@ int BIKPlayer::Play()
 	return ret;
 }
 
-//this code could be in the movieplayer parent class
-void static get_current_time(long &sec, long &usec) {
-#ifdef _WIN32
-	DWORD time;
-	time = GetTickCount();
-
-	sec = time / 1000;
-	usec = (time % 1000) * 1000;
-#else
-	struct timeval tv;
-	gettimeofday(&tv, NULL);
-
-	sec = tv.tv_sec;
-	usec = tv.tv_usec;
-#endif
-}
-
-void BIKPlayer::timer_start()
-{
-	get_current_time(timer_last_sec, timer_last_usec);
-}
-
-void BIKPlayer::timer_wait()
-{
-	long sec, usec;
-	get_current_time(sec, usec);
-
-	while (sec > timer_last_sec) {
-		usec += 1000000;
-		timer_last_sec++;
-	}
-
-	//quick hack, we should rather use the rational time base as ffmpeg
-	frame_wait = v_timebase.num*1000000/v_timebase.den;
-	while (usec - timer_last_usec > (long)frame_wait) {
-		usec -= frame_wait;
-		video_frameskip++;
-	}
-
-	long to_sleep = frame_wait - (usec - timer_last_usec);
-#ifdef _WIN32
-	Sleep(to_sleep / 1000);
-#else
-	usleep(to_sleep);
-#endif
-
-	timer_start();
-}
-
-bool BIKPlayer::next_frame()
+// runs on the decoding thread if MoviePlayer decodes ahead
+bool BIKPlayer::DecodeFrame(MovieFrame& movieFrame)
 {
-	if (timer_last_sec) {
-		timer_wait();
-	}
 	if(frameCount>=header.framecount) {
 		return false;
 	}
+	decoding = &movieFrame;
+	movieFrame.number = frameCount;
 	binkframe frame = frames[frameCount++];
 	str->Seek(frame.pos, GEM_STREAM_START);
 	ieDword audframesize;
 	str->ReadDword(&audframesize);
 	frame.size = str->Read( inbuff, frame.size - 4 );
-	if (s_stream > -1 && DecodeAudioFrame(inbuff, audframesize)) {
-		//buggy frame, we stop immediately
-		//return false;
-	}
-	if (DecodeVideoFrame(inbuff+audframesize, frame.size-audframesize)) {
-		//buggy frame, we stop immediately
-		return false;
-	}
-	if (!timer_last_sec) {
-		timer_start();
+	unsigned long start = GetMicroTicks();
+	if (s_stream > -1) {
+		//the audio is decoded while the main thread does the video
+		audio_task->data = inbuff;
+		audio_task->size = audframesize;
+		decode_pool->Submit(audio_task);
+	}
+	int ret = DecodeVideoFrame(inbuff+audframesize, frame.size-audframesize);
+	//the audio is done with inbuff only now
+	decode_pool->Wait();
+	decode_time += GetMicroTicks() - start;
+	decoded_frames++;
+	if (s_stream > -1) {
+		//buggy audio frames are played as far as they got
+		QueueAudioFrame();
+	}
+	decoding = NULL;
+	//buggy frame, we stop immediately
+	return ret == 0;
+}
+
+void BIKPlayer::ShowFrame(MovieFrame& frame)
+{
+	unsigned char *planes[3];
+	unsigned int strides[3];
+	strides[0] = frame.width;
+	strides[1] = strides[2] = (frame.width + 1) >> 1;
+	planes[0] = &frame.pixels[0];
+	planes[1] = planes[0] + strides[0] * frame.height;
+	planes[2] = planes[1] + strides[1] * ((frame.height + 1) >> 1);
+
+	ieDword titleref = 0;
+	if (cbAtFrame && strRef) {
+		if ((rowCount<maxRow) && (frame.number + 1 >= cbAtFrame[rowCount]) ) {
+			rowCount++;
+		}
+		//draw subtitle here
+		if (rowCount) {
+			titleref = strRef[rowCount-1];
+		}
 	}
-	return true;
+
+	unsigned int dest_x = (outputwidth - frame.width) >> 1;
+	unsigned int dest_y = (outputheight - frame.height) >> 1;
+	video->showYUVFrame(planes, strides, frame.width, frame.height, frame.width, frame.height, dest_x, dest_y, titleref);
 }
 
 int BIKPlayer::doPlay()
 {
-	int done = 0;
-
 	//bink is always truecolor
 	g_truecolor = 1;
 
-	frame_wait = 0;
-	timer_last_sec = 0;
-	video_frameskip = 0;
-
 	if (sound_init( core->GetAudioDrv()->CanPlay())) {
 		//sound couldn't be initialized
 		return 1;
@@ -328,9 +358,15 @@ int BIKPlayer::doPlay()
 		return 2;
 	}
 
-	while (!done && next_frame()) {
-		done = video->PollMovieEvents();
+#ifdef BENCHMARK_BINK
+	MovieFrame frame;
+	while (DecodeFrame(frame)) {
+		frame.audio.clear();
 	}
+#else
+	//quick hack, we should rather use the rational time base as ffmpeg
+	PlayFrames(v_timebase.num*1000000/v_timebase.den);
+#endif
 
 	video->DestroyMovieScreen();
 	return 0;
@@ -342,23 +378,6 @@ unsigned int BIKPlayer::fileRead(unsigned int pos, void* buf, unsigned int count
 	return str->Read( buf, count );
 }
 
-void BIKPlayer::showFrame(unsigned char** buf, unsigned int *strides, unsigned int bufw,
-	unsigned int bufh, unsigned int w, unsigned int h, unsigned int dstx, unsigned int dsty)
-{
-	ieDword titleref = 0;
-
-	if (cbAtFrame && strRef) {
-		if ((rowCount<maxRow) && (frameCount >= cbAtFrame[rowCount]) ) {
-			rowCount++;
-		}
-		//draw subtitle here
-		if (rowCount) {
-			titleref = strRef[rowCount-1];
-		}
-	}
-	video->showYUVFrame(buf,strides,bufw,bufh,w,h,dstx,dsty, titleref);
-}
-
 int BIKPlayer::setAudioStream()
 {
 	ieDword volume;
@@ -373,12 +392,6 @@ void BIKPlayer::freeAudioStream(int stream)
 		core->GetAudioDrv()->ReleaseStream(stream, true);
 }
 
-void BIKPlayer::queueBuffer(int stream, unsigned short bits, int channels, short* memory, int size, int samplerate)
-{
-	if (stream > -1)
-		core->GetAudioDrv()->QueueBuffer(stream, bits, channels, memory, size, samplerate);
-}
-
 
 /**
  * @file libavcodec/binkaudio.c
@@ -756,12 +769,23 @@ int BIKPlayer::DecodeAudioFrame(void *data, int data_size)
 	//ret is a better value here as it provides almost perfect sound.
 	//Original ffmpeg code produces worse results with reported_size.
 	//Ideally ret == reported_size
-	queueBuffer(s_stream, 16, s_channels, samples, ret, header.samplerate);
-
-	free(samples);
+	//it is queued by the main thread, this may run on a worker
+	s_samples = samples;
+	s_samples_size = ret;
 	return reported_size!=ret;
 }
 
+void BIKPlayer::QueueAudioFrame()
+{
+	if (!s_samples) {
+		return;
+	}
+	//it goes out when the frame is shown
+	AddAudio(*decoding, s_stream, 16, s_channels, s_samples, s_samples_size, header.samplerate);
+	free(s_samples);
+	s_samples = NULL;
+}
+
 /**
  * Reads 8x8 block of DCT coefficients.
  *
@@ -1361,16 +1385,216 @@ static void bink_idct(DCTELEM *block)
 	}
 }
 
-static void idct_put(uint8_t *dest, int line_size, DCTELEM *block)
+#ifdef SIMD_SSE2
+// low 32 bits of a * c for 0 <= c < 0x10000, from 16 bit products:
+// a * c = ((high half * c) << 16) + low half * c
+static inline __m128i mul_epi32(__m128i a, int c)
+{
+	__m128i b = _mm_set1_epi16((short) c);
+	return _mm_add_epi32(_mm_mullo_epi16(a, b), _mm_slli_epi32(_mm_mulhi_epu16(a, b), 16));
+}
+
+static inline void transpose4(__m128i &a, __m128i &b, __m128i &c, __m128i &d)
+{
+	__m128i t0 = _mm_unpacklo_epi32(a, b);
+	__m128i t1 = _mm_unpacklo_epi32(c, d);
+	__m128i t2 = _mm_unpackhi_epi32(a, b);
+	__m128i t3 = _mm_unpackhi_epi32(c, d);
+	a = _mm_unpacklo_epi64(t0, t1);
+	b = _mm_unpackhi_epi64(t0, t1);
+	c = _mm_unpacklo_epi64(t2, t3);
+	d = _mm_unpackhi_epi64(t2, t3);
+}
+
+// one pass of bink_idct on four lanes, in[k] and out[k] are the k-th
+// elements of the lanes' columns (or rows), they may be the same array
+static inline void bink_idct_1d(const __m128i *in, __m128i *out)
+{
+	__m128i t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, tA, tB, tC;
+
+	t0 = _mm_add_epi32(in[0], in[4]);
+	t1 = _mm_sub_epi32(in[0], in[4]);
+	t2 = _mm_add_epi32(in[2], in[6]);
+	t3 = _mm_sub_epi32(in[2], in[6]);
+	t3 = _mm_sub_epi32(_mm_srai_epi32(mul_epi32(t3, 0xB50), 11), t2);
+
+	t4 = _mm_sub_epi32(t0, t2);
+	t5 = _mm_add_epi32(t0, t2);
+	t6 = _mm_add_epi32(t1, t3);
+	t7 = _mm_sub_epi32(t1, t3);
+
+	t0 = _mm_add_epi32(in[5], in[3]);
+	t1 = _mm_sub_epi32(in[5], in[3]);
+	t2 = _mm_add_epi32(in[1], in[7]);
+	t3 = _mm_sub_epi32(in[1], in[7]);
+
+	t8 = _mm_add_epi32(t2, t0);
+	t9 = _mm_add_epi32(t3, t1);
+	t9 = _mm_srai_epi32(mul_epi32(t9, 0xEC8), 11);
+	tA = _mm_sub_epi32(_mm_setzero_si128(), mul_epi32(t1, 0x14E8));
+	tA = _mm_sub_epi32(_mm_add_epi32(_mm_srai_epi32(tA, 11), t9), t8);
+	tB = _mm_sub_epi32(t2, t0);
+	tB = _mm_sub_epi32(_mm_srai_epi32(mul_epi32(tB, 0xB50), 11), tA);
+	tC = _mm_sub_epi32(_mm_add_epi32(_mm_srai_epi32(mul_epi32(t3, 0x8A9), 11), tB), t9);
+
+	out[0] = _mm_add_epi32(t5, t8);
+	out[7] = _mm_sub_epi32(t5, t8);
+	out[1] = _mm_add_epi32(t6, tA);
+	out[6] = _mm_sub_epi32(t6, tA);
+	out[2] = _mm_add_epi32(t7, tB);
+	out[5] = _mm_sub_epi32(t7, tB);
+	out[4] = _mm_add_epi32(t4, tC);
+	out[3] = _mm_sub_epi32(t4, tC);
+}
+
+// rounds like the scalar version and truncates to DCTELEM, as packing
+// would saturate
+static inline __m128i idct_descale(__m128i x)
+{
+	x = _mm_srai_epi32(_mm_add_epi32(x, _mm_set1_epi32(0x7F)), 8);
+	return _mm_srai_epi32(_mm_slli_epi32(x, 16), 16);
+}
+
+// second pass on four rows, whose columns are in lo (0-3) and hi (4-7)
+static inline void bink_idct_rows(DCTELEM *block, __m128i *lo, __m128i *hi)
+{
+	__m128i c[8];
+
+	transpose4(lo[0], lo[1], lo[2], lo[3]);
+	transpose4(hi[0], hi[1], hi[2], hi[3]);
+	c[0] = lo[0]; c[1] = lo[1]; c[2] = lo[2]; c[3] = lo[3];
+	c[4] = hi[0]; c[5] = hi[1]; c[6] = hi[2]; c[7] = hi[3];
+	bink_idct_1d(c, c);
+	c[0] = idct_descale(c[0]); c[1] = idct_descale(c[1]);
+	c[2] = idct_descale(c[2]); c[3] = idct_descale(c[3]);
+	c[4] = idct_descale(c[4]); c[5] = idct_descale(c[5]);
+	c[6] = idct_descale(c[6]); c[7] = idct_descale(c[7]);
+	transpose4(c[0], c[1], c[2], c[3]);
+	transpose4(c[4], c[5], c[6], c[7]);
+	_mm_storeu_si128((__m128i *) (block +  0), _mm_packs_epi32(c[0], c[4]));
+	_mm_storeu_si128((__m128i *) (block +  8), _mm_packs_epi32(c[1], c[5]));
+	_mm_storeu_si128((__m128i *) (block + 16), _mm_packs_epi32(c[2], c[6]));
+	_mm_storeu_si128((__m128i *) (block + 24), _mm_packs_epi32(c[3], c[7]));
+}
+
+// bink_idct four columns and then four rows at a time, unrolled, so the
+// compiler keeps everything in registers
+static void bink_idct_sse2(DCTELEM *block)
+{
+	// the left and right four columns of each row
+	__m128i lo[8], hi[8];
+
+#define IDCT_LOAD_ROW(i) \
+	lo[i] = _mm_loadu_si128((const __m128i *) (block + (i)*8)); \
+	hi[i] = _mm_srai_epi32(_mm_unpackhi_epi16(lo[i], lo[i]), 16); \
+	lo[i] = _mm_srai_epi32(_mm_unpacklo_epi16(lo[i], lo[i]), 16);
+
+	IDCT_LOAD_ROW(0) IDCT_LOAD_ROW(1) IDCT_LOAD_ROW(2) IDCT_LOAD_ROW(3)
+	IDCT_LOAD_ROW(4) IDCT_LOAD_ROW(5) IDCT_LOAD_ROW(6) IDCT_LOAD_ROW(7)
+#undef IDCT_LOAD_ROW
+
+	bink_idct_1d(lo, lo);
+	bink_idct_1d(hi, hi);
+	bink_idct_rows(block, lo, hi);
+	bink_idct_rows(block + 32, lo + 4, hi + 4);
+}
+
+static void put_pixels_sse2(const DCTELEM *block, uint8_t *pixels, int line_size)
+{
+	const __m128i mask = _mm_set1_epi16(0xFF);
+	for (int i = 0; i < 8; i++) {
+		__m128i row = _mm_and_si128(_mm_loadu_si128((const __m128i *) block), mask);
+		_mm_storel_epi64((__m128i *) pixels, _mm_packus_epi16(row, row));
+		pixels += line_size;
+		block += 8;
+	}
+}
+
+static void add_pixels_sse2(const DCTELEM *block, uint8_t *pixels, int line_size)
+{
+	const __m128i mask = _mm_set1_epi16(0xFF);
+	const __m128i zero = _mm_setzero_si128();
+	for (int i = 0; i < 8; i++) {
+		__m128i row = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) pixels), zero);
+		row = _mm_add_epi16(row, _mm_loadu_si128((const __m128i *) block));
+		row = _mm_and_si128(row, mask);
+		_mm_storel_epi64((__m128i *) pixels, _mm_packus_epi16(row, row));
+		pixels += line_size;
+		block += 8;
+	}
+}
+#endif
+
+static inline void run_idct(DCTELEM *block)
 {
+#ifdef SIMD_SSE2
+#ifdef VALIDATE_SIMD
+	DCTELEM check[64];
+	memcpy(check, block, sizeof(check));
+	bink_idct(check);
+#endif
+	bink_idct_sse2(block);
+#ifdef VALIDATE_SIMD
+	if (memcmp(check, block, sizeof(check))) {
+		Log(ERROR, "BIKPlayer", "SSE2 idct differs from the scalar one!");
+	}
+#endif
+#else
 	bink_idct(block);
+#endif
+}
+
+static void idct_put(uint8_t *dest, int line_size, DCTELEM *block)
+{
+	run_idct(block);
+#ifdef SIMD_SSE2
+	put_pixels_sse2(block, dest, line_size);
+#else
 	put_pixels_nonclamped(block, dest, line_size);
+#endif
 }
 
 static void idct_add(uint8_t *dest, int line_size, DCTELEM *block)
 {
-	bink_idct(block);
+	run_idct(block);
+#ifdef SIMD_SSE2
+	add_pixels_sse2(block, dest, line_size);
+#else
 	add_pixels_nonclamped(block, dest, line_size);
+#endif
+}
+
+// the scaled intra blocks cover 16x16 pixels
+static void idct_put_scaled(uint8_t *dst, int stride, DCTELEM *block)
+{
+	run_idct(block);
+	for (int j = 0; j < 8; j++) {
+		for (int i = 0; i < 8; i++) {
+			PUT2x2(dst, stride, i, j, block[i + j*8]);
+		}
+	}
+}
+
+void DCTJob::Run()
+{
+	switch (mode) {
+		case DCT_PUT:
+			idct_put(dst, stride, block);
+			break;
+		case DCT_ADD:
+			idct_add(dst, stride, block);
+			break;
+		case DCT_PUT_SCALED:
+			idct_put_scaled(dst, stride, block);
+			break;
+	}
+}
+
+void DCTBand::Run()
+{
+	for (size_t i = begin; i < end; i++) {
+		jobs[i].Run();
+	}
 }
 
 int BIKPlayer::DecodeVideoFrame(void *data, int data_size)
@@ -1384,11 +1608,13 @@ int BIKPlayer::DecodeVideoFrame(void *data, int data_size)
 #pragma pack(push,16)
 	DCTELEM block[64];
 #pragma pack(pop)
+	DCTELEM *dct;
 
 	int bits = data_size*8;
 	v_gb.init_get_bits((uint8_t *) data, bits);
 	//this is compatible only with the BIKi version
 	v_gb.skip_bits(32);
+	dct_jobs.clear();
 
 	get_buffer(&c_pic, header.width, header.height);
 	//plane order is YUV
@@ -1473,15 +1699,9 @@ int BIKPlayer::DecodeVideoFrame(void *data, int data_size)
 						}
 						break;
 					case INTRA_BLOCK:
-						clear_block(block);
-						block[0] = get_value(BINK_SRC_INTRA_DC);
-						read_dct_coeffs(block, c_scantable.permutated,true);
-						bink_idct(block);
-						for (j = 0; j < 8; j++) {
-							for (i = 0; i < 8; i++) {
-								PUT2x2(dst, stride, i, j, block[i + j*8]);
-							}
-						}
+						dct = AddDCTJob(dst, stride, DCT_PUT_SCALED);
+						dct[0] = get_value(BINK_SRC_INTRA_DC);
+						read_dct_coeffs(dct, c_scantable.permutated,true);
 						break;
 					case FILL_BLOCK:
 						v = get_value(BINK_SRC_COLORS);
@@ -1553,10 +1773,9 @@ int BIKPlayer::DecodeVideoFrame(void *data, int data_size)
 					add_pixels_nonclamped(block, dst, stride);
 					break;
 				case INTRA_BLOCK:
-					clear_block(block);
-					block[0] = get_value(BINK_SRC_INTRA_DC);
-					read_dct_coeffs(block, c_scantable.permutated,true);
-					idct_put(dst, stride, block);
+					dct = AddDCTJob(dst, stride, DCT_PUT);
+					dct[0] = get_value(BINK_SRC_INTRA_DC);
+					read_dct_coeffs(dct, c_scantable.permutated,true);
 					break;
 				case FILL_BLOCK:
 					v = get_value(BINK_SRC_COLORS);
@@ -1568,10 +1787,9 @@ int BIKPlayer::DecodeVideoFrame(void *data, int data_size)
 					xoff = get_value(BINK_SRC_X_OFF);
 					yoff = get_value(BINK_SRC_Y_OFF);
 					copy_block(block, prev + xoff + yoff*stride, dst, stride);
-					clear_block(block);
-					block[0] = get_value(BINK_SRC_INTER_DC);
-					read_dct_coeffs(block, c_scantable.permutated,false);
-					idct_add(dst, stride, block);
+					dct = AddDCTJob(dst, stride, DCT_ADD);
+					dct[0] = get_value(BINK_SRC_INTER_DC);
+					read_dct_coeffs(dct, c_scantable.permutated,false);
 					break;
 				case PATTERN_BLOCK:
 					c1 = get_value(BINK_SRC_COLORS);
@@ -1597,23 +1815,61 @@ int BIKPlayer::DecodeVideoFrame(void *data, int data_size)
 		}
 		v_gb.get_bits_align32();
 	}
+	RunDCTJobs();
 
-	if (video_frameskip) {
-		video_frameskip--;
-		video_skippedframes++;
-	} else {
-		unsigned int dest_x = (outputwidth - header.width) >> 1;
-		unsigned int dest_y = (outputheight - header.height) >> 1;
-		showFrame((ieByte **) c_pic.data, (unsigned int *) c_pic.linesize, header.width, header.height, header.width, header.height, dest_x, dest_y);
-	}
+	//the planes are kept for the next frame's motion blocks, so the
+	//shown picture is a copy
+	unsigned int luma = c_pic.linesize[0] * header.height;
+	unsigned int chroma = c_pic.linesize[1] * ((header.height + 1) >> 1);
+	decoding->width = header.width;
+	decoding->height = header.height;
+	decoding->pixels.resize(luma + 2 * chroma);
+	memcpy(&decoding->pixels[0], c_pic.data[0], luma);
+	memcpy(&decoding->pixels[luma], c_pic.data[1], chroma);
+	memcpy(&decoding->pixels[luma + chroma], c_pic.data[2], chroma);
 
-	//release the old frame even when frame is skipped
 	release_buffer(&c_last);
 	memcpy(&c_last, &c_pic, sizeof(AVFrame));
 	memset(&c_pic, 0, sizeof(AVFrame));
 	return 0;
 }
 
+DCTELEM *BIKPlayer::AddDCTJob(uint8_t *dst, int stride, int mode)
+{
+	dct_jobs.resize(dct_jobs.size() + 1);
+	DCTJob &job = dct_jobs.back();
+	job.dst = dst;
+	job.stride = stride;
+	job.mode = mode;
+	clear_block(job.block);
+	return job.block;
+}
+
+void BIKPlayer::RunDCTJobs()
+{
+	// split the blocks into one band per thread, the main thread does one
+	size_t count = dct_jobs.size();
+	int bandCount = decode_pool->GetThreadCount() + 1;
+	if (count < 64 * (size_t) bandCount) {
+		bandCount = 1;
+	}
+
+	dct_bands.resize(bandCount);
+	for (int i = 0; i < bandCount; i++) {
+		dct_bands[i].jobs = count ? &dct_jobs[0] : NULL;
+		dct_bands[i].begin = i * count / bandCount;
+		dct_bands[i].end = (i + 1) * count / bandCount;
+		if (i) {
+			decode_pool->Submit(&dct_bands[i]);
+		}
+	}
+	dct_bands[0].Run();
+	if (bandCount > 1) {
+		decode_pool->Wait();
+	}
+	dct_jobs.clear();
+}
+
 #include "plugindef.h"
 
 GEMRB_PLUGIN(0x316E2EDE, "BIK Video Player")
@@ -27,6 +27,7 @@
 #include "win32def.h"
 
 #include "Interface.h"
+#include "System/Threading.h"
 
 // FIXME: This has to be included last, since it defines int*_t, which causes
 // mingw g++ 4.5.0 to choke.
@@ -153,7 +154,41 @@ typedef struct Bundle {
 	  uint8_t *cur_ptr;  ///< pointer to the data that is not read from buffer yet
 } Bundle;
 
+enum DCTModes {
+	  DCT_PUT,        ///< idct result replaces the pixels
+	  DCT_ADD,        ///< idct result is added to the motion compensated pixels
+	  DCT_PUT_SCALED  ///< idct result replaces 16x16 pixels
+};
+
+/**
+ * An 8x8 block whose idct is done after the frame's bitstream is parsed.
+ * It only touches its own pixels, the motion blocks read the previous
+ * frame, so the jobs can run in any order and on several threads.
+ */
+struct DCTJob {
+	uint8_t *dst;
+	int stride;
+	int mode;
+	DCTELEM block[64];
+
+	void Run();
+};
+
+/** A share of the frame's dct blocks, run by one thread */
+class DCTBand : public Task {
+public:
+	DCTBand() : jobs(NULL), begin(0), end(0) {}
+
+	void Run();
+
+	DCTJob* jobs;
+	size_t begin, end;
+};
+
+class BinkAudioTask;
+
 class BIKPlayer : public MoviePlayer {
+	friend class BinkAudioTask;
 private:
 	Video *video;
 	bool validVideo;
@@ -177,6 +212,8 @@ private:
 	int s_first;
 	bool s_audio;
 	int s_stream;  //openal stream handle
+	short *s_samples; ///< decoded audio of the current frame
+	unsigned int s_samples_size;
 
 #pragma pack(push,16)
 	FFTSample s_coeffs[BINK_BLOCK_MAX_SIZE];
@@ -193,14 +230,8 @@ private:
 
 	//video context (consider packing it in a struct)
 	AVRational v_timebase;
-	long timer_last_sec;
-	long timer_last_usec;
-	unsigned int frame_wait;
-	bool video_rendered_frame;
-	unsigned int video_frameskip;
-	bool done;
 	int outputwidth, outputheight;
-	unsigned int video_skippedframes;
+	MovieFrame *decoding; ///< receives the frame and audio being decoded
 	//bink specific
 	ScanTable c_scantable;
 	Bundle c_bundle[BINK_NB_SRC];  ///< bundles for decoding all data types
@@ -212,22 +243,21 @@ private:
 	int16_t table[16 * 128][2];
 	GetBitContext v_gb;
 	AVFrame c_pic, c_last;
+	std::vector<DCTJob> dct_jobs; ///< idct blocks of the current frame
+	std::vector<DCTBand> dct_bands; ///< dct_jobs split between the threads
+	WorkerPool *decode_pool;
+	BinkAudioTask *audio_task;
+	//decoding statistics
+	unsigned long decode_time;
+	unsigned int decoded_frames;
 
 private:
-	void timer_start();
-	void timer_wait();
 	void segment_video_play();
-	bool next_frame();
 	int doPlay();
 	unsigned int fileRead(unsigned int pos, void* buf, unsigned int count);
-	void showFrame(unsigned char** buf, unsigned int *strides, unsigned int bufw,
-		unsigned int bufh, unsigned int w, unsigned int h, unsigned int dstx,
-		unsigned int dsty);
 	int pollEvents();
 	int setAudioStream();
 	void freeAudioStream(int stream);
-	void queueBuffer(int stream, unsigned short bits,
-		int channels, short* memory, int size, int samplerate);
 	int sound_init(bool need_init);
 	void ff_init_scantable(ScanTable *st, const uint8_t *src_scantable);
 	int video_init(int w, int h);
@@ -235,6 +265,7 @@ private:
 	int ReadHeader();
 	void DecodeBlock(short *out);
 	int DecodeAudioFrame(void *data, int data_size);
+	void QueueAudioFrame();
 	inline int get_value(int bundle);
 	int read_dct_coeffs(DCTELEM block[64], const uint8_t *scan, bool is_intra);
 	int read_residue(DCTELEM block[64], int masks_count);
@@ -248,8 +279,13 @@ private:
 	void read_bundle(int bundle_num);
 	void init_lengths(int width, int bw);
 	int DecodeVideoFrame(void *data, int data_size);
+	DCTELEM *AddDCTJob(uint8_t *dst, int stride, int mode);
+	void RunDCTJobs();
 	int EndAudio();
 	int EndVideo();
+protected:
+	bool DecodeFrame(MovieFrame& frame);
+	void ShowFrame(MovieFrame& frame);
 public:
 	BIKPlayer(void);
 	~BIKPlayer(void);
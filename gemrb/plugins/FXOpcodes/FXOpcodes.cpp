@@ -432,7 +432,7 @@ int fx_unknown (Scriptable* Owner, Actor* target, Effect* fx);//???
 // FIXME: Make this an ordered list, so we could use bsearch!
 static EffectDesc effectnames[] = {
 	{ "*Crash*", fx_crash, EFFECT_NO_ACTOR, -1 },
-	{ "AcidResistanceModifier", fx_acid_resistance_modifier, 0, -1 },
+	{ "AcidResistanceModifier", fx_acid_resistance_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "ACVsCreatureType", fx_generic_effect, 0, -1 }, //0xdb
 	{ "ACVsDamageTypeModifier", fx_ac_vs_damage_type_modifier, 0, -1 },
 	{ "ACVsDamageTypeModifier2", fx_ac_vs_damage_type_modifier, 0, -1 }, // used in IWD
@@ -450,7 +450,7 @@ static EffectDesc effectnames[] = {
 	{ "ApplyEffectItemType", fx_apply_effect_item_type, 0, -1 },
 	{ "ApplyEffectRepeat", fx_apply_effect_repeat, 0, -1 },
 	{ "CutScene2", fx_cutscene2, EFFECT_NO_ACTOR, -1 },
-	{ "AttackSpeedModifier", fx_attackspeed_modifier, 0, -1 },
+	{ "AttackSpeedModifier", fx_attackspeed_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "AttacksPerRoundModifier", fx_attacks_per_round_modifier, 0, -1 },
 	{ "AuraCleansingModifier", fx_auracleansing_modifier, 0, -1 },
 	{ "SummonDisable", fx_summon_disable, 0, -1 }, //unknown
@@ -476,7 +476,7 @@ static EffectDesc effectnames[] = {
 	{ "CastingGlow", fx_casting_glow, 0, -1 },
 	{ "CastingGlow2", fx_casting_glow, 0, -1 }, //used in iwd
 	{ "CastingLevelModifier", fx_castinglevel_modifier, 0, -1 },
-	{ "CastingSpeedModifier", fx_castingspeed_modifier, 0, -1 },
+	{ "CastingSpeedModifier", fx_castingspeed_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "CastSpellOnCondition", fx_cast_spell_on_condition, 0, -1 },
 	{ "ChangeBardSong", fx_change_bardsong, 0, -1 },
 	{ "ChangeName", fx_change_name, 0, -1 },
@@ -486,7 +486,7 @@ static EffectDesc effectnames[] = {
 	{ "ChaosShieldModifier", fx_chaos_shield_modifier, 0, -1 },
 	{ "CharismaModifier", fx_charisma_modifier, 0, -1 },
 	{ "CheckForBerserkModifier", fx_checkforberserk_modifier, 0, -1 },
-	{ "ColdResistanceModifier", fx_cold_resistance_modifier, 0, -1 },
+	{ "ColdResistanceModifier", fx_cold_resistance_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "Color:BriefRGB", fx_brief_rgb, 0, -1 },
 	{ "Color:GlowRGB", fx_glow_rgb, 0, -1 },
 	{ "Color:DarkenRGB", fx_darken_rgb, 0, -1 },
@@ -495,11 +495,11 @@ static EffectDesc effectnames[] = {
 	{ "Color:SetRGBGlobal", fx_set_color_rgb_global, 0, -1 }, //08
 	{ "Color:PulseRGB", fx_set_color_pulse_rgb, 0, -1 }, //9
 	{ "Color:PulseRGBGlobal", fx_set_color_pulse_rgb_global, 0, -1 }, //9
-	{ "ConstitutionModifier", fx_constitution_modifier, 0, -1 },
+	{ "ConstitutionModifier", fx_constitution_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "ControlCreature", fx_set_charmed_state, 0, -1 }, //0xf1 same as charm
 	{ "CreateContingency", fx_create_contingency, 0, -1 },
-	{ "CriticalHitModifier", fx_critical_hit_modifier, 0, -1 },
-	{ "CrushingResistanceModifier", fx_crushing_resistance_modifier, 0, -1 },
+	{ "CriticalHitModifier", fx_critical_hit_modifier, EFFECT_STAT_LOCAL, -1 },
+	{ "CrushingResistanceModifier", fx_crushing_resistance_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "Cure:Berserk", fx_cure_berserk_state, 0, -1 },
 	{ "Cure:Blind", fx_cure_blind_state, 0, -1 },
 	{ "Cure:CasterHold", fx_unpause_caster, 0, -1 },
@@ -528,14 +528,14 @@ static EffectDesc effectnames[] = {
 	{ "CurrentHPModifier", fx_current_hp_modifier, EFFECT_DICED, -1 },
 	{ "Damage", fx_damage, EFFECT_DICED, -1 },
 	{ "DamageAnimation", fx_damage_animation, 0, -1 },
-	{ "DamageBonusModifier", fx_damage_bonus_modifier, 0, -1 },
-	{ "DamageLuckModifier", fx_damageluck_modifier, 0, -1 },
+	{ "DamageBonusModifier", fx_damage_bonus_modifier, EFFECT_STAT_LOCAL, -1 },
+	{ "DamageLuckModifier", fx_damageluck_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "DamageVsCreature", fx_generic_effect, 0, -1 },
 	{ "Death", fx_death, 0, -1 },
 	{ "Death2", fx_death, 0, -1 }, //(iwd2 effect)
 	{ "Death3", fx_death, 0, -1 }, //(iwd2 effect too, Banish)
 	{ "DetectAlignment", fx_detect_alignment, 0, -1 },
-	{ "DetectIllusionsModifier", fx_detect_illusion_modifier, 0, -1 },
+	{ "DetectIllusionsModifier", fx_detect_illusion_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "DexterityModifier", fx_dexterity_modifier, 0, -1 },
 	{ "DimensionDoor", fx_dimension_door, 0, -1 },
 	{ "DisableButton", fx_disable_button, 0, -1 }, //sets disable button flag
@@ -554,26 +554,26 @@ static EffectDesc effectnames[] = {
 	{ "DrainItems", fx_drain_items, 0, -1 },
 	{ "DrainSpells", fx_drain_spells, 0, -1 },
 	{ "DropWeapon", fx_drop_weapon, 0, -1 },
-	{ "ElectricityResistanceModifier", fx_electricity_resistance_modifier, 0, -1 },
+	{ "ElectricityResistanceModifier", fx_electricity_resistance_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "ExistanceDelayModifier", fx_existance_delay_modifier , 0, -1 }, //unknown
 	{ "ExperienceModifier", fx_experience_modifier, 0, -1 },
 	{ "ExploreModifier", fx_explore_modifier, 0, -1 },
 	{ "FamiliarBond", fx_familiar_constitution_loss, 0, -1 },
 	{ "FamiliarMarker", fx_familiar_marker, 0, -1 },
 	{ "Farsee", fx_farsee, 0, -1 },
-	{ "FatigueModifier", fx_fatigue_modifier, 0, -1 },
+	{ "FatigueModifier", fx_fatigue_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "FindFamiliar", fx_find_familiar, 0, -1 },
 	{ "FindTraps", fx_find_traps, 0, -1 },
-	{ "FindTrapsModifier", fx_find_traps_modifier, 0, -1 },
-	{ "FireResistanceModifier", fx_fire_resistance_modifier, 0, -1 },
-	{ "FistDamageModifier", fx_fist_damage_modifier, 0, -1 },
-	{ "FistHitModifier", fx_fist_to_hit_modifier, 0, -1 },
+	{ "FindTrapsModifier", fx_find_traps_modifier, EFFECT_STAT_LOCAL, -1 },
+	{ "FireResistanceModifier", fx_fire_resistance_modifier, EFFECT_STAT_LOCAL, -1 },
+	{ "FistDamageModifier", fx_fist_damage_modifier, EFFECT_STAT_LOCAL, -1 },
+	{ "FistHitModifier", fx_fist_to_hit_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "ForceSurgeModifier", fx_force_surge_modifier, 0, -1 },
 	{ "ForceVisible", fx_force_visible, 0, -1 }, //not invisible but improved invisible
 	{ "FreeAction", fx_cure_slow_state, 0, -1 },
 	{ "GenerateWish", fx_generate_wish, 0, -1 },
 	{ "GoldModifier", fx_gold_modifier, 0, -1 },
-	{ "HideInShadowsModifier", fx_hide_in_shadows_modifier, 0, -1 },
+	{ "HideInShadowsModifier", fx_hide_in_shadows_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "HLA", fx_generic_effect, 0, -1 },
 	{ "HolyNonCumulative", fx_set_holy_state, 0, -1 },
 	{ "Icon:Disable", fx_disable_portrait_icon, 0, -1 },
@@ -581,8 +581,8 @@ static EffectDesc effectnames[] = {
 	{ "Icon:Remove", fx_remove_portrait_icon, 0, -1 },
 	{ "Identify", fx_identify, 0, -1 },
 	{ "IgnoreDialogPause", fx_ignore_dialogpause_modifier, 0, -1 },
-	{ "IntelligenceModifier", fx_intelligence_modifier, 0, -1 },
-	{ "IntoxicationModifier", fx_intoxication_modifier, 0, -1 },
+	{ "IntelligenceModifier", fx_intelligence_modifier, EFFECT_STAT_LOCAL, -1 },
+	{ "IntoxicationModifier", fx_intoxication_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "InvisibleDetection", fx_see_invisible_modifier, 0, -1 },
 	{ "Item:CreateDays", fx_create_item_days, 0, -1 },
 	{ "Item:CreateInSlot", fx_create_item_in_slot, 0, -1 },
@@ -592,44 +592,44 @@ static EffectDesc effectnames[] = {
 	{ "Item:Remove", fx_remove_item, 0, -1 }, //70
 	{ "Item:RemoveInventory", fx_remove_inventory_item, 0, -1 },
 	{ "KillCreatureType", fx_kill_creature_type, 0, -1 },
-	{ "LevelModifier", fx_level_modifier, 0, -1 },
+	{ "LevelModifier", fx_level_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "LevelDrainModifier", fx_leveldrain_modifier, 0, -1 },
 	{ "LoreModifier", fx_lore_modifier, 0, -1 },
 	{ "LuckModifier", fx_luck_modifier, EFFECT_NO_LEVEL_CHECK, -1 },
 	{ "LuckCumulative", fx_luck_cumulative, 0, -1 },
 	{ "LuckNonCumulative", fx_luck_non_cumulative, 0, -1 },
-	{ "MagicalColdResistanceModifier", fx_magical_cold_resistance_modifier, 0, -1 },
-	{ "MagicalFireResistanceModifier", fx_magical_fire_resistance_modifier, 0, -1 },
+	{ "MagicalColdResistanceModifier", fx_magical_cold_resistance_modifier, EFFECT_STAT_LOCAL, -1 },
+	{ "MagicalFireResistanceModifier", fx_magical_fire_resistance_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "MagicalRest", fx_magical_rest, 0, -1 },
-	{ "MagicDamageResistanceModifier", fx_magic_damage_resistance_modifier, 0, -1 },
+	{ "MagicDamageResistanceModifier", fx_magic_damage_resistance_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "MagicResistanceModifier", fx_magic_resistance_modifier, 0, -1 },
 	{ "MassRaiseDead", fx_mass_raise_dead, EFFECT_NO_ACTOR, -1 },
 	{ "MaximumHPModifier", fx_maximum_hp_modifier, EFFECT_DICED, -1 },
 	{ "Maze", fx_maze, 0, -1 },
-	{ "MeleeDamageModifier", fx_melee_damage_modifier, 0, -1 },
-	{ "MeleeHitModifier", fx_melee_to_hit_modifier, 0, -1 },
-	{ "MinimumHPModifier", fx_minimum_hp_modifier, 0, -1 },
+	{ "MeleeDamageModifier", fx_melee_damage_modifier, EFFECT_STAT_LOCAL, -1 },
+	{ "MeleeHitModifier", fx_melee_to_hit_modifier, EFFECT_STAT_LOCAL, -1 },
+	{ "MinimumHPModifier", fx_minimum_hp_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "MiscastMagicModifier", fx_miscast_magic_modifier, 0, -1 },
-	{ "MissileDamageModifier", fx_missile_damage_modifier, 0, -1 },
-	{ "MissileHitModifier", fx_missile_to_hit_modifier, 0, -1 },
-	{ "MissilesResistanceModifier", fx_missiles_resistance_modifier, 0, -1 },
+	{ "MissileDamageModifier", fx_missile_damage_modifier, EFFECT_STAT_LOCAL, -1 },
+	{ "MissileHitModifier", fx_missile_to_hit_modifier, EFFECT_STAT_LOCAL, -1 },
+	{ "MissilesResistanceModifier", fx_missiles_resistance_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "MirrorImage", fx_mirror_image, 0, -1 },
 	{ "MirrorImageModifier", fx_mirror_image_modifier, 0, -1 },
 	{ "ModifyGlobalVariable", fx_modify_global_variable, EFFECT_NO_ACTOR, -1 },
 	{ "ModifyLocalVariable", fx_modify_local_variable, 0, -1 },
 	{ "MonsterSummoning", fx_monster_summoning, EFFECT_NO_ACTOR, -1 },
 	{ "MoraleBreakModifier", fx_morale_break_modifier, 0, -1 },
-	{ "MoraleModifier", fx_morale_modifier, 0, -1 },
+	{ "MoraleModifier", fx_morale_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "MovementRateModifier", fx_movement_modifier, 0, -1 }, //fast (7e)
 	{ "MovementRateModifier2", fx_movement_modifier, 0, -1 },//slow (b0)
 	{ "MovementRateModifier3", fx_movement_modifier, 0, -1 },//forced (IWD - 10a)
 	{ "MovementRateModifier4", fx_movement_modifier, 0, -1 },//slow (IWD2 - 1b9)
 	{ "MoveToArea", fx_move_to_area, 0, -1 }, //0xba
 	{ "NoCircleState", fx_no_circle_state, 0, -1 },
-	{ "NPCBump", fx_npc_bump, 0, -1 },
+	{ "NPCBump", fx_npc_bump, EFFECT_STAT_LOCAL, -1 },
 	{ "OffscreenAIModifier", fx_offscreenai_modifier, 0, -1 },
-	{ "OffhandHitModifier", fx_left_to_hit_modifier, 0, -1 },
-	{ "OpenLocksModifier", fx_open_locks_modifier, 0, -1 },
+	{ "OffhandHitModifier", fx_left_to_hit_modifier, EFFECT_STAT_LOCAL, -1 },
+	{ "OpenLocksModifier", fx_open_locks_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "Overlay:Entangle", fx_set_entangle_state, 0, -1 },
 	{ "Overlay:Grease", fx_set_grease_state, 0, -1 },
 	{ "Overlay:MinorGlobe", fx_set_minorglobe_state, 0, -1 },
@@ -637,12 +637,12 @@ static EffectDesc effectnames[] = {
 	{ "Overlay:ShieldGlobe", fx_set_shieldglobe_state, 0, -1 },
 	{ "Overlay:Web", fx_set_web_state, 0, -1 },
 	{ "PauseTarget", fx_pause_target, 0, -1 }, //also known as casterhold
-	{ "PickPocketsModifier", fx_pick_pockets_modifier, 0, -1 },
-	{ "PiercingResistanceModifier", fx_piercing_resistance_modifier, 0, -1 },
+	{ "PickPocketsModifier", fx_pick_pockets_modifier, EFFECT_STAT_LOCAL, -1 },
+	{ "PiercingResistanceModifier", fx_piercing_resistance_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "PlayMovie", fx_play_movie, EFFECT_NO_ACTOR, -1 },
 	{ "PlaySound", fx_playsound, EFFECT_NO_ACTOR, -1 },
 	{ "PlayVisualEffect", fx_play_visual_effect, EFFECT_REINIT_ON_LOAD, -1 },
-	{ "PoisonResistanceModifier", fx_poison_resistance_modifier, 0, -1 },
+	{ "PoisonResistanceModifier", fx_poison_resistance_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "Polymorph", fx_polymorph, 0, -1 },
 	{ "PortraitChange", fx_portrait_change, 0, -1 },
 	{ "PowerWordKill", fx_power_word_kill, 0, -1 },
@@ -685,7 +685,7 @@ static EffectDesc effectnames[] = {
 	{ "ReputationModifier", fx_reputation_modifier, 0, -1 },
 	{ "RestoreSpells", fx_restore_spell_level, 0, -1 },
 	{ "RetreatFrom2", fx_turn_undead, 0, -1 },
-	{ "RightHitModifier", fx_right_to_hit_modifier, 0, -1 },
+	{ "RightHitModifier", fx_right_to_hit_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "SaveVsBreathModifier", fx_save_vs_breath_modifier, 0, -1 },
 	{ "SaveVsDeathModifier", fx_save_vs_death_modifier, 0, -1 },
 	{ "SaveVsPolyModifier", fx_save_vs_poly_modifier, 0, -1 },
@@ -702,9 +702,9 @@ static EffectDesc effectnames[] = {
 	{ "SetMeleeEffect", fx_generic_effect, 0, -1 },
 	{ "SetRangedEffect", fx_generic_effect, 0, -1 },
 	{ "SetTrap", fx_set_area_effect, 0, -1 },
-	{ "SetTrapsModifier", fx_set_traps_modifier, 0, -1 },
+	{ "SetTrapsModifier", fx_set_traps_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "SexModifier", fx_sex_modifier, 0, -1 },
-	{ "SlashingResistanceModifier", fx_slashing_resistance_modifier, 0, -1 },
+	{ "SlashingResistanceModifier", fx_slashing_resistance_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "Sparkle", fx_sparkle, 0, -1 },
 	{ "SpellDurationModifier", fx_spell_duration_modifier, 0, -1 },
 	{ "Spell:Add", fx_add_innate, 0, -1 },
@@ -744,11 +744,11 @@ static EffectDesc effectnames[] = {
 	{ "State:Sleep", fx_set_unconscious_state, 0, -1 },
 	{ "State:Slowed", fx_set_slowed_state, 0, -1 },
 	{ "State:Stun", fx_set_stun_state, 0, -1 },
-	{ "StealthModifier", fx_stealth_modifier, 0, -1 },
+	{ "StealthModifier", fx_stealth_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "StoneSkinModifier", fx_stoneskin_modifier, 0, -1 },
 	{ "StoneSkin2Modifier", fx_golem_stoneskin_modifier, 0, -1 },
 	{ "StrengthModifier", fx_strength_modifier, 0, -1 },
-	{ "StrengthBonusModifier", fx_strength_bonus_modifier, 0, -1 },
+	{ "StrengthBonusModifier", fx_strength_bonus_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "SummonCreature", fx_summon_creature, EFFECT_NO_ACTOR, -1 },
 	{ "RandomTeleport", fx_teleport_field, 0, -1 },
 	{ "TeleportToTarget", fx_teleport_to_target, 0, -1 },
@@ -758,7 +758,7 @@ static EffectDesc effectnames[] = {
 	{ "ToHitModifier", fx_to_hit_modifier, 0, -1 },
 	{ "ToHitBonusModifier", fx_to_hit_bonus_modifier, 0, -1 },
 	{ "ToHitVsCreature", fx_generic_effect, 0, -1 },
-	{ "TrackingModifier", fx_tracking_modifier, 0, -1 },
+	{ "TrackingModifier", fx_tracking_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "TransparencyModifier", fx_transparency_modifier, 0, -1 },
 	{ "TurnUndead", fx_turn_undead, 0, -1 },
 	{ "UncannyDodge", fx_uncanny_dodge, 0, -1 },
@@ -767,11 +767,11 @@ static EffectDesc effectnames[] = {
 	{ "UnsummonCreature", fx_unsummon_creature, 0, -1 },
 	{ "Variable:StoreLocalVariable", fx_local_variable, 0, -1 },
 	{ "VisualAnimationEffect", fx_visual_animation_effect, 0, -1 }, //unknown
-	{ "VisualRangeModifier", fx_visual_range_modifier, 0, -1 },
+	{ "VisualRangeModifier", fx_visual_range_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "VisualSpellHit", fx_visual_spell_hit, 0, -1 },
-	{ "WildSurgeModifier", fx_wild_surge_modifier, 0, -1 },
+	{ "WildSurgeModifier", fx_wild_surge_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "WingBuffet", fx_wing_buffet, 0, -1 },
-	{ "WisdomModifier", fx_wisdom_modifier, 0, -1 },
+	{ "WisdomModifier", fx_wisdom_modifier, EFFECT_STAT_LOCAL, -1 },
 	{ "WizardSpellSlotsModifier", fx_bonus_wizard_spells, 0, -1 },
 	{ NULL, NULL, 0, 0 },
 };
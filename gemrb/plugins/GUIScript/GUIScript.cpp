@@ -65,6 +65,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <vector>
 
 // MIPSPro fix for IRIX
 size_t strlcpy(char *, const char *, size_t);
@@ -9909,6 +9910,24 @@ static PyObject* GemRB_MessageWindowDebug(PyObject * /*self*/, PyObject* args)
 	Py_RETURN_NONE;
 }
 
+PyDoc_STRVAR( GemRB_ReportCallbackTimes__doc,
+			 "ReportCallbackTimes([count=10, reset=0])\n\n"
+			 "Shows the script functions run by the engine which took the most time,"
+			 " optionally starting the count anew." );
+
+static PyObject* GemRB_ReportCallbackTimes(PyObject * /*self*/, PyObject* args)
+{
+	int count = 10;
+	int reset = 0;
+	if (!PyArg_ParseTuple( args, "|ii", &count, &reset )) {
+		return AttributeError( GemRB_ReportCallbackTimes__doc );
+	}
+
+	gs->ReportFunctionTimes(count > 0 ? count : 0, reset != 0);
+
+	Py_RETURN_NONE;
+}
+
 PyDoc_STRVAR( GemRB_GetCurrentArea__doc,
 "===== GetCurrentArea =====\n\
 \n\
@@ -15466,6 +15485,7 @@ static PyMethodDef GemRBMethods[] = {
 	METHOD(RemoveItem, METH_VARARGS),
 	METHOD(RemoveSpell, METH_VARARGS),
 	METHOD(RemoveEffects, METH_VARARGS),
+	METHOD(ReportCallbackTimes, METH_VARARGS),
 	METHOD(RestParty, METH_VARARGS),
 	METHOD(RevealArea, METH_VARARGS),
 	METHOD(Roll, METH_VARARGS),
@@ -15636,6 +15656,13 @@ GUIScript::~GUIScript(void)
 		if (pModule) {
 			Py_DECREF( pModule );
 		}
+		FunctionMap::iterator it;
+		for (it = functions.begin(); it != functions.end(); it++) {
+			Py_XDECREF(it->second.module);
+			Py_XDECREF(it->second.moduleName);
+			Py_DECREF(it->second.name);
+		}
+		functions.clear();
 		Py_Finalize();
 	}
 	if (ItemArray) {
@@ -15893,6 +15920,52 @@ bool GUIScript::LoadScript(const char* filename)
 	return true;
 }
 
+// looks up the module and the interned function name only once, the
+// module is imported again if it was replaced in sys.modules since then
+GUIScript::ScriptFunction* GUIScript::GetFunction(const char* moduleName, const char* functionName)
+{
+	// functions of the current script are kept under its name, so each
+	// window script has its own entries
+	const char* scriptName = moduleName;
+	if (!scriptName) {
+		if (!pModule) {
+			return NULL;
+		}
+		scriptName = PyModule_GetName(pModule);
+		if (!scriptName) {
+			PyErr_Clear();
+			return NULL;
+		}
+	}
+
+	std::pair<std::string, std::string> key(scriptName, functionName);
+	FunctionMap::iterator it = functions.find(key);
+	if (it == functions.end()) {
+		ScriptFunction function;
+		function.module = NULL;
+		function.moduleName = PyString_InternFromString(scriptName);
+		function.name = PyString_InternFromString(functionName);
+		function.calls = 0;
+		function.time = 0;
+		it = functions.insert(std::make_pair(key, function)).first;
+	}
+
+	ScriptFunction& function = it->second;
+	// the current script, it is kept by LoadScript
+	if (!moduleName) {
+		return &function;
+	}
+	if (!function.module || PyDict_GetItem(PyImport_GetModuleDict(), function.moduleName) != function.module) {
+		Py_XDECREF(function.module);
+		function.module = PyImport_ImportModule(const_cast<char*>(moduleName));
+		if (!function.module) {
+			PyErr_Print();
+			return NULL;
+		}
+	}
+	return &function;
+}
+
 /* Similar to RunFunction, but with parameters, and doesn't necessarily fail */
 PyObject *GUIScript::RunFunction(const char* moduleName, const char* functionName, PyObject* pArgs, bool report_error)
 {
@@ -15900,29 +15973,30 @@ PyObject *GUIScript::RunFunction(const char* moduleName, const char* functionNam
 		return NULL;
 	}
 
-	PyObject *module;
-	if (moduleName) {
-		module = PyImport_ImportModule(const_cast<char*>(moduleName));
-	} else {
-		module = pModule;
-		Py_XINCREF(module);
-	}
-	if (module == NULL) {
-		PyErr_Print();
+	ScriptFunction* function = GetFunction(moduleName, functionName);
+	if (!function) {
 		return NULL;
 	}
+	// the function may load another script or module, so keep this one alive
+	PyObject *module = moduleName ? function->module : pModule;
+	Py_INCREF(module);
 	PyObject *dict = PyModule_GetDict(module);
 
-	PyObject *pFunc = PyDict_GetItemString(dict, const_cast<char*>(functionName));
+	// looked up on each call, so a reloaded module is picked up right away
+	PyObject *pFunc = PyDict_GetItem(dict, function->name);
 	/* pFunc: Borrowed reference */
 	if (!pFunc || !PyCallable_Check(pFunc)) {
 		if (report_error) {
-			Log(ERROR, "GUIScript", "Missing function: %s from %s", functionName, moduleName);
+			Log(ERROR, "GUIScript", "Missing function: %s from %s", functionName, PyString_AsString(function->moduleName));
 		}
 		Py_DECREF(module);
 		return NULL;
 	}
+	unsigned __int64 start = GetMicroTicks();
 	PyObject *pValue = PyObject_CallObject( pFunc, pArgs );
+	// entries are never removed, so the pointer is still good
+	function->time += GetMicroTicks() - start;
+	function->calls++;
 	if (pValue == NULL) {
 		if (PyErr_Occurred()) {
 			PyErr_Print();
@@ -15932,6 +16006,44 @@ PyObject *GUIScript::RunFunction(const char* moduleName, const char* functionNam
 	return pValue;
 }
 
+static bool SlowerFunction(const std::pair<unsigned __int64, std::string>& a, const std::pair<unsigned __int64, std::string>& b)
+{
+	return a.first > b.first;
+}
+
+void GUIScript::ReportFunctionTimes(unsigned int count, bool reset)
+{
+	std::vector<std::pair<unsigned __int64, std::string> > times;
+	char buf[256];
+	FunctionMap::iterator it;
+	for (it = functions.begin(); it != functions.end(); it++) {
+		ScriptFunction& function = it->second;
+		if (!function.calls) {
+			continue;
+		}
+		snprintf(buf, sizeof(buf), "%.2f ms in %u calls: %s.%s", function.time / 1000.0,
+			function.calls, it->first.first.c_str(), it->first.second.c_str());
+		times.push_back(std::make_pair(function.time, std::string(buf)));
+		if (reset) {
+			function.calls = 0;
+			function.time = 0;
+		}
+	}
+	std::sort(times.begin(), times.end(), SlowerFunction);
+	if (times.size() > count) {
+		times.resize(count);
+	}
+
+	for (size_t i = 0; i < times.size(); i++) {
+		Log(MESSAGE, "GUIScript", "%s", times[i].second.c_str());
+		if (displaymsg) {
+			String* msg = StringFromCString(times[i].second.c_str());
+			displaymsg->DisplayString(*msg, DMC_WHITE, NULL);
+			delete msg;
+		}
+	}
+}
+
 bool GUIScript::RunFunction(const char *moduleName, const char* functionName, bool report_error, int intparam)
 {
 	PyObject *pArgs;
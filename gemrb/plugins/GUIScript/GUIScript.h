@@ -32,6 +32,11 @@
 #endif
 
 #include "ScriptEngine.h"
+#include "ie_types.h"
+
+#include <map>
+#include <string>
+#include <utility>
 
 namespace GemRB {
 
@@ -66,6 +71,21 @@ public:
 	PyObject *RunFunction(const char* moduleName, const char* fname, PyObject* pArgs, bool report_error = true);
 	PyObject* ConstructObject(const char* classname, int arg);
 	PyObject* ConstructObject(const char* classname, PyObject* pArgs);
+	/** Reports the functions run by the engine which took the most time */
+	void ReportFunctionTimes(unsigned int count, bool reset);
+private:
+	// a function run by name, with its module and the time spent in it
+	struct ScriptFunction {
+		PyObject* module;
+		PyObject* moduleName;
+		PyObject* name;
+		unsigned int calls;
+		unsigned __int64 time;
+	};
+	typedef std::map<std::pair<std::string, std::string>, ScriptFunction> FunctionMap;
+	FunctionMap functions;
+
+	ScriptFunction* GetFunction(const char* moduleName, const char* functionName);
 };
 
 extern GUIScript *gs;
@@ -25,6 +25,7 @@
 #include "globals.h"
 #include "win32def.h"
 
+#include <cctype>
 #include <cstring>
 
 using namespace GemRB;
@@ -73,6 +74,12 @@ bool IDSImporter::Open(DataStream* str)
 		str = strtok( NULL, " " );
 		p.str = str;
 		if (str != NULL) {
+			int index = (int) pairs.size();
+			byString.insert(std::make_pair(std::string(str), index));
+			const char* paren = strchr(str, '(');
+			if (paren) {
+				byName[std::string(str, paren - str + 1)] = index;
+			}
 			ptrs.push_back( line );
 			pairs.push_back( p );
 		} else {
@@ -86,12 +93,15 @@ bool IDSImporter::Open(DataStream* str)
 
 int IDSImporter::GetValue(const char* txt) const
 {
-	for (unsigned int i = 0; i < pairs.size(); i++) {
-		if (stricmp( pairs[i].str, txt ) == 0) {
-			return pairs[i].val;
-		}
+	std::string key = txt;
+	for (size_t i = 0; i < key.length(); i++) {
+		key[i] = (char) tolower((unsigned char) key[i]);
 	}
-	return -1;
+	std::map<std::string, int>::const_iterator it = byString.find(key);
+	if (it == byString.end()) {
+		return -1;
+	}
+	return pairs[it->second].val;
 }
 
 char* IDSImporter::GetValue(int val) const
@@ -122,6 +132,18 @@ int IDSImporter::GetValueIndex(unsigned int Index) const
 
 int IDSImporter::FindString(char *str, int len) const
 {
+	// the usual case is looking up an action or trigger name with its '('
+	if (len > 0 && str[len-1] == '(' && !memchr(str, '(', len-1)) {
+		std::string key(str, len);
+		for (int j = 0; j < len; j++) {
+			key[j] = (char) tolower((unsigned char) key[j]);
+		}
+		std::map<std::string, int>::const_iterator it = byName.find(key);
+		if (it == byName.end()) {
+			return -1;
+		}
+		return it->second;
+	}
 	int i=pairs.size();
 	while(i--) {
 		if (strnicmp(pairs[i].str, str, len) == 0) {
@@ -23,6 +23,8 @@
 
 #include "SymbolMgr.h"
 
+#include <map>
+#include <string>
 #include <vector>
 
 namespace GemRB {
@@ -36,6 +38,10 @@ class IDSImporter : public SymbolMgr {
 private:
 	std::vector< Pair> pairs;
 	std::vector< char*> ptrs;
+	// first pair by its whole (lowercase) string, for GetValue
+	std::map<std::string, int> byString;
+	// last pair by its name up to and including the '(', for FindString
+	std::map<std::string, int> byName;
 
 public:
 	IDSImporter(void);
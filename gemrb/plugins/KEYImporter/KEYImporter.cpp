@@ -43,11 +43,9 @@ KEYImporter::~KEYImporter(void)
 	}
 }
 
-static char* AddCBF(char *file)
+// the key may be opened on a startup thread, so no static buffer here
+static char* AddCBF(char *cbf, const char *file)
 {
-	// This is safe in single-threaded, since the
-	// return value is passed straight to PathJoin.
-	static char cbf[_MAX_PATH];
 	strcpy(cbf,file);
 	char *dot = strrchr(cbf, '.');
 	if (dot)
@@ -63,7 +61,8 @@ static bool PathExists(BIFEntry *entry, const char *path)
 	if (file_exists(entry->path)) {
 		return true;
 	}
-	PathJoin(entry->path, path, AddCBF(entry->name), NULL);
+	char cbf[_MAX_PATH];
+	PathJoin(entry->path, path, AddCBF(cbf, entry->name), NULL);
 	if (file_exists(entry->path)) {
 		return true;
 	}
@@ -49,6 +49,10 @@ MVEPlay::MVEPlay(void)
 {
 	video = core->GetVideoDriver();
 	validVideo = false;
+	player = NULL;
+	decoding = NULL;
+	frameNumber = 0;
+	outputwidth = outputheight = 0;
 }
 
 MVEPlay::~MVEPlay(void)
@@ -92,30 +96,28 @@ int MVEPlay::Play()
 
 int MVEPlay::doPlay()
 {
-	int done = 0;
-	MVEPlayer player(this);
+	MVEPlayer mve(this);
 
 	memset( g_palette, 0, 768 );
 
 	//ieDword volume;
 	//core->GetDictionary()->Lookup( "Volume Movie", volume );
-	player.sound_init( core->GetAudioDrv()->CanPlay() );
+	mve.sound_init( core->GetAudioDrv()->CanPlay() );
 
-	int w,h;
+	video->InitMovieScreen(outputwidth, outputheight);
+	mve.video_init(outputwidth, outputheight);
 
-	video->InitMovieScreen(w,h);
-	player.video_init(w, h);
-
-	if (!player.start_playback()) {
+	if (!mve.start_playback()) {
 		print("Failed to decode movie!");
 		return 1;
 	}
 
-	g_truecolor = player.is_truecolour();
+	g_truecolor = mve.is_truecolour();
 
-	while (!done && player.next_frame()) {
-		done = video->PollMovieEvents();
-	}
+	player = &mve;
+	frameNumber = 0;
+	PlayFrames(mve.get_frame_wait());
+	player = NULL;
 
 	video->DrawMovieSubtitle(0);
 	video->DestroyMovieScreen();
@@ -130,9 +132,28 @@ unsigned int MVEPlay::fileRead(void* buf, unsigned int count)
 	return ( numread == count );
 }
 
-void MVEPlay::showFrame(unsigned char* buf, unsigned int bufw,
-	unsigned int bufh, unsigned int sx, unsigned int sy, unsigned int w,
-	unsigned int h, unsigned int dstx, unsigned int dsty)
+// runs on the decoding thread if MoviePlayer decodes ahead
+bool MVEPlay::DecodeFrame(MovieFrame& frame)
+{
+	decoding = &frame;
+	frame.number = frameNumber++;
+	bool ret = player->next_frame();
+	decoding = NULL;
+	return ret;
+}
+
+// the frame's pixels are followed by the palette they were drawn with
+void MVEPlay::storeFrame(unsigned char* buf, unsigned int bufw, unsigned int bufh)
+{
+	unsigned int size = bufw * bufh * (g_truecolor ? 2 : 1);
+	decoding->width = bufw;
+	decoding->height = bufh;
+	decoding->pixels.resize(size + sizeof(g_palette));
+	memcpy(&decoding->pixels[0], buf, size);
+	memcpy(&decoding->pixels[size], g_palette, sizeof(g_palette));
+}
+
+void MVEPlay::ShowFrame(MovieFrame& frame)
 {
 	ieDword titleref = 0;
 
@@ -146,7 +167,10 @@ void MVEPlay::showFrame(unsigned char* buf, unsigned int bufw,
 			titleref = strRef[rowCount-1];
 		}
 	}
-	video->showFrame(buf,bufw,bufh,sx,sy,w,h,dstx,dsty, g_truecolor, g_palette, titleref);
+	unsigned int size = frame.width * frame.height * (g_truecolor ? 2 : 1);
+	unsigned int dstx = (outputwidth - frame.width) >> 1;
+	unsigned int dsty = (outputheight - frame.height) >> 1;
+	video->showFrame(&frame.pixels[0], frame.width, frame.height, 0, 0, frame.width, frame.height, dstx, dsty, g_truecolor, &frame.pixels[size], titleref);
 }
 
 void MVEPlay::setPalette(unsigned char* p, unsigned start, unsigned count)
@@ -179,8 +203,14 @@ void MVEPlay::queueBuffer(int stream, unsigned short bits,
 			int channels, short* memory,
 			int size, int samplerate)
 {
-	if (stream > -1)
-		core->GetAudioDrv()->QueueBuffer(stream, bits, channels, memory, size, samplerate) ;
+	if (!decoding) {
+		//sound before the first frame
+		if (stream > -1)
+			core->GetAudioDrv()->QueueBuffer(stream, bits, channels, memory, size, samplerate) ;
+		return;
+	}
+	//it goes out when the frame is shown
+	AddAudio(*decoding, stream, bits, channels, memory, size, samplerate);
 }
 
 
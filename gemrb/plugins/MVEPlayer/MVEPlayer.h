@@ -30,17 +30,20 @@
 
 namespace GemRB {
 
+class MVEPlayer;
+
 class MVEPlay : public MoviePlayer {
 	friend class MVEPlayer;
 private:
 	Video *video;
 	bool validVideo;
+	MVEPlayer *player;
+	MovieFrame *decoding;
+	unsigned int frameNumber;
+	int outputwidth, outputheight;
 	int doPlay();
 	unsigned int fileRead(void* buf, unsigned int count);
-	void showFrame(unsigned char* buf, unsigned int bufw,
-		unsigned int bufh, unsigned int sx, unsigned int sy,
-		unsigned int w, unsigned int h, unsigned int dstx,
-		unsigned int dsty);
+	void storeFrame(unsigned char* buf, unsigned int bufw, unsigned int bufh);
 	void setPalette(unsigned char* p, unsigned start, unsigned count);
 	int pollEvents();
 	int setAudioStream();
@@ -48,6 +51,9 @@ private:
 	void queueBuffer(int stream, unsigned short bits,
 				int channels, short* memory,
 				int size, int samplerate);
+protected:
+	bool DecodeFrame(MovieFrame& frame);
+	void ShowFrame(MovieFrame& frame);
 public:
 	MVEPlay(void);
 	~MVEPlay(void);
@@ -30,10 +30,6 @@
 #include "gstmvedemux.h"
 #include "mve.h"
 
-#ifdef HAVE_UNISTD_H
-#include <unistd.h>
-#endif
-
 /* mvevideodec8.cpp */
 extern int ipvideo_decode_frame8 (const GstMveDemuxStream * s,
 	const unsigned char *data, unsigned short len);
@@ -56,14 +52,10 @@ MVEPlayer::MVEPlayer(class MVEPlay *file) {
 
 	audio_buffer = NULL;
 	frame_wait = 0;
-	timer_last_sec = 0;
 
 	video_data = NULL;
 	video_back_buf = NULL;
 
-	video_frameskip = 0;
-	video_skippedframes = 0;
-
 	audio_stream = -1;
 
 	playsound = true;
@@ -80,9 +72,6 @@ MVEPlayer::~MVEPlayer() {
 	if (video_back_buf) free(video_back_buf);
 
 	if (audio_stream != -1) host->freeAudioStream(audio_stream);
-
-	if (video_skippedframes)
-		print("Warning: Had to drop %d video frame(s).", video_skippedframes);
 }
 
 /*
@@ -115,16 +104,12 @@ bool MVEPlayer::start_playback() {
 }
 
 bool MVEPlayer::next_frame() {
-	if (timer_last_sec) timer_wait();
-
 	video_rendered_frame = false;
 	while (!video_rendered_frame) {
 		if (done) return false;
 		if (!process_chunk()) return false;
 	}
 
-	if (!timer_last_sec) timer_start();
-
 	return true;
 }
 
@@ -237,53 +222,9 @@ bool MVEPlayer::process_segment(unsigned short len, unsigned char type, unsigned
 }
 
 /*
- * timer handling
+ * timer handling, the frames are paced by MoviePlayer::PlayFrames
  */
 
-static void get_current_time(long &sec, long &usec) {
-#ifdef _WIN32
-	DWORD time;
-	time = GetTickCount();
-
-	sec = time / 1000;
-	usec = (time % 1000) * 1000;
-#else
-	struct timeval tv;
-	gettimeofday(&tv, NULL);
-
-	sec = tv.tv_sec;
-	usec = tv.tv_usec;
-#endif
-}
-
-void MVEPlayer::timer_start() {
-	get_current_time(timer_last_sec, timer_last_usec);
-}
-
-void MVEPlayer::timer_wait() {
-	long sec, usec;
-	get_current_time(sec, usec);
-
-	while (sec > timer_last_sec) {
-		usec += 1000000;
-		timer_last_sec++;
-	}
-
-	while (usec - timer_last_usec > (long)frame_wait) {
-		usec -= frame_wait;
-		video_frameskip++;
-	}
-
-	long to_sleep = frame_wait - (usec - timer_last_usec);
-#ifdef _WIN32
-	Sleep(to_sleep / 1000);
-#else
-	usleep(to_sleep);
-#endif
-
-	timer_start();
-}
-
 void MVEPlayer::segment_create_timer() {
 	/* new frame every (timer_rate * timer_subdiv) microseconds */
 	unsigned int timer_rate = GST_READ_UINT32_LE(buffer);
@@ -405,14 +346,7 @@ void MVEPlayer::segment_video_data(unsigned short size) {
 }
 
 void MVEPlayer::segment_video_play() {
-	if (video_frameskip) {
-		video_frameskip--;
-		video_skippedframes++;
-	} else {
-		unsigned int dest_x = (outputwidth - video_data->width) >> 1;
-		unsigned int dest_y = (outputheight - video_data->height) >> 1;
-		host->showFrame( (guint8 *) video_data->back_buf1, video_data->width, video_data->height, 0, 0, video_data->width, video_data->height, dest_x, dest_y);
-	}
+	host->storeFrame( (guint8 *) video_data->back_buf1, video_data->width, video_data->height);
 
 	video_rendered_frame = true;
 }
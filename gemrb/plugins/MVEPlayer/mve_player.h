@@ -36,8 +36,6 @@ protected:
 	unsigned int outputwidth;
 	unsigned int outputheight;
 
-	long timer_last_sec;
-	long timer_last_usec;
 	unsigned int frame_wait;
 
 	_GstMveDemuxStream *video_data;
@@ -46,8 +44,6 @@ protected:
 	unsigned short *video_back_buf;
 	bool truecolour;
 	bool video_rendered_frame;
-	unsigned int video_frameskip;
-	unsigned int video_skippedframes;
 
 	bool audio_compressed;
 	int audio_num_channels;
@@ -67,8 +63,6 @@ protected:
 			unsigned char type, unsigned char version);
 
 	void segment_create_timer();
-	void timer_start();
-	void timer_wait();
 
 	void segment_video_init(unsigned char version);
 	void segment_video_mode();
@@ -92,6 +86,8 @@ public:
 	bool next_frame();
 	
 	bool is_truecolour() { return truecolour; }
+	/* microseconds between two frames */
+	unsigned int get_frame_wait() { return frame_wait; }
 };
 
 }
@@ -23,10 +23,59 @@
 #include "GameData.h"
 
 #include <cassert>
+#include <cctype>
 #include <cstdio>
 
 using namespace GemRB;
 
+namespace GemRB {
+
+// decodes a sound opened on the game thread into memory, the AL buffer is
+// only created by the next loadSound for it
+class SoundDecoder : public Task {
+public:
+	SoundDecoder(OpenALAudioDriver* driver, Holder<SoundMgr> reader)
+		: driver(driver), reader(reader), memory(NULL), size(0), done(false)
+	{
+		cnt = reader->get_length();
+		channels = reader->get_channels();
+		samplerate = reader->get_samplerate();
+		time_length = ((cnt / channels) * 1000) / samplerate;
+	}
+	~SoundDecoder() { free(memory); }
+
+	void Run()
+	{
+		short* decoded = (short*) malloc(cnt * 2);
+		int read = reader->read_samples(decoded, cnt) * 2;
+
+		StackLock l(driver->bufferMutex, "bufferMutex in SoundDecoder::Run()");
+		memory = decoded;
+		size = read;
+		done = true;
+		SDL_CondBroadcast(driver->decodeDone);
+	}
+
+	OpenALAudioDriver* driver;
+	Holder<SoundMgr> reader;
+	int cnt, channels, samplerate;
+	unsigned int time_length;
+	short* memory;
+	int size;
+	bool done;
+};
+
+}
+
+static std::string DecodeKey(const char* ResRef)
+{
+	std::string key;
+	for (int i = 0; i < 8 && ResRef[i]; i++) {
+		key += (char) tolower((unsigned char) ResRef[i]);
+	}
+	return key;
+}
+
 static bool checkALError(const char* msg, log_level level) {
 	int error = alGetError();
 	if (error != AL_NO_ERROR) {
@@ -128,6 +177,7 @@ void AudioStream::ClearIfStopped()
 		Source = 0;
 		Buffer = 0;
 		free = true;
+		pending[0] = 0;
 		if (handle) { handle->Invalidate(); handle.release(); }
 		ambient = false;
 		locked = false;
@@ -153,9 +203,13 @@ OpenALAudioDriver::OpenALAudioDriver(void)
 	MusicSource = num_streams = 0;
 	memset(MusicBuffer, 0, MUSICBUFFERS*sizeof(ALuint));
 	musicMutex = SDL_CreateMutex();
+	bufferMutex = SDL_CreateMutex();
+	decodeDone = SDL_CreateCond();
 	ambim = NULL;
 	musicThread = NULL;
 	stayAlive = false;
+	decodePool = NULL;
+	asyncDecodes = lateSounds = skippedSounds = 0;
 }
 
 void OpenALAudioDriver::PrintDeviceList ()
@@ -223,6 +277,10 @@ bool OpenALAudioDriver::Init(void)
 	ambim = new AmbientMgrAL;
 	speech.free = true;
 	speech.ambient = false;
+
+	if (decodeLatency) {
+		decodePool = new WorkerPool(1);
+	}
 	return true;
 }
 
@@ -267,6 +325,17 @@ OpenALAudioDriver::~OpenALAudioDriver(void)
 	}
 	speech.ForceClear();
 	ResetMusics();
+
+	// the remaining decodes still run before the thread quits
+	delete decodePool;
+	std::map<std::string, SoundDecoder*>::iterator it;
+	for (it = decodes.begin(); it != decodes.end(); ++it) {
+		delete it->second;
+	}
+	if (asyncDecodes) {
+		Log(DEBUG, "OpenAL", "Decoded %u sounds in the background, %u effects started late and %u were skipped waiting for one",
+			asyncDecodes, lateSounds, skippedSounds);
+	}
 	clearBufferCache(true);
 
 	ALCdevice *device;
@@ -282,39 +351,109 @@ OpenALAudioDriver::~OpenALAudioDriver(void)
 
 	SDL_DestroyMutex(musicMutex);
 	musicMutex = NULL;
+	SDL_DestroyMutex(bufferMutex);
+	bufferMutex = NULL;
+	SDL_DestroyCond(decodeDone);
+	decodeDone = NULL;
 
 	free(music_memory);
 
 	delete ambim;
 }
 
-ALuint OpenALAudioDriver::loadSound(const char *ResRef, unsigned int &time_length)
+void OpenALAudioDriver::Preload(const char *ResRef)
 {
-	ALuint Buffer = 0;
+	if (!decodePool || !ResRef || !ResRef[0]) {
+		return;
+	}
+
+	std::string key = DecodeKey(ResRef);
+	{
+		StackLock l(bufferMutex, "bufferMutex in Preload()");
+		void* p;
+		if (buffercache.Lookup(ResRef, p) || decodes.count(key)) {
+			return;
+		}
+	}
 
+	// finding and opening the file stays on this thread, only decoding is done in the background
+	ResourceHolder<SoundMgr> acm(ResRef, true);
+	if (!acm) {
+		return;
+	}
+	SoundDecoder* decoder = new SoundDecoder(this, acm);
+	{
+		StackLock l(bufferMutex, "bufferMutex in Preload()");
+		if (decodes.count(key)) {
+			delete decoder;
+			return;
+		}
+		decodes[key] = decoder;
+		asyncDecodes++;
+	}
+	decodePool->Submit(decoder);
+}
+
+// a sound still being decoded in the background is waited for at most
+// maxWait milliseconds (-1 waits until it is done), if it takes longer 0 is
+// returned, pending is set and time_length is still filled in
+ALuint OpenALAudioDriver::loadSound(const char *ResRef, unsigned int &time_length,
+	int maxWait, bool* pending)
+{
 	CacheEntry *e;
 	void* p;
 
 	if (!ResRef[0]) {
 		return 0;
 	}
+	StackLock l(bufferMutex, "bufferMutex in loadSound()");
 	if(buffercache.Lookup(ResRef, p))
 	{
 		e = (CacheEntry*) p;
 		time_length = e->Length;
+		buffercache.Touch(ResRef);
 		return e->Buffer;
 	}
 
-	//no cache entry...
-	alGenBuffers(1, &Buffer);
-	if (checkALError("Unable to create sound buffer", ERROR)) {
-		return 0;
+	std::string key = DecodeKey(ResRef);
+	std::map<std::string, SoundDecoder*>::iterator it = decodes.find(key);
+	if (it != decodes.end()) {
+		SoundDecoder* decoder = it->second;
+		unsigned long start = GetTickCount();
+		while (!decoder->done) {
+			if (maxWait < 0) {
+				SDL_CondWait(decodeDone, bufferMutex);
+				continue;
+			}
+			unsigned long waited = GetTickCount() - start;
+			if (waited >= (unsigned long) maxWait) {
+				time_length = decoder->time_length;
+				if (pending) {
+					*pending = true;
+				}
+				return 0;
+			}
+			SDL_CondWaitTimeout(decodeDone, bufferMutex, maxWait - waited);
+		}
+
+		// another thread may have finished it while we waited
+		if(buffercache.Lookup(ResRef, p))
+		{
+			e = (CacheEntry*) p;
+			time_length = e->Length;
+			return e->Buffer;
+		}
+		decodes.erase(key);
+		time_length = decoder->time_length;
+		ALuint Buffer = createBuffer(ResRef, decoder->memory, decoder->size,
+			decoder->channels, decoder->samplerate, time_length);
+		delete decoder;
+		return Buffer;
 	}
 
+	//no cache entry...
 	ResourceHolder<SoundMgr> acm(ResRef);
 	if (!acm) {
-		alDeleteBuffers( 1, &Buffer );
-		checkALError("Unable to delete buffer!", ERROR);
 		return 0;
 	}
 	int cnt = acm->get_length();
@@ -327,9 +466,29 @@ ALuint OpenALAudioDriver::loadSound(const char *ResRef, unsigned int &time_lengt
 	int cnt1 = acm->read_samples( memory, cnt ) * 2;
 	//Sound Length in milliseconds
 	time_length = ((cnt / riff_chans) * 1000) / samplerate;
-	//it is always reading the stuff into 16 bits
-	alBufferData( Buffer, GetFormatEnum( riff_chans, 16 ), memory, cnt1, samplerate );
+	ALuint Buffer = createBuffer(ResRef, memory, cnt1, riff_chans, samplerate, time_length);
 	free(memory);
+	return Buffer;
+}
+
+// creates the AL buffer for decoded samples and caches it,
+// the caller has to hold bufferMutex
+ALuint OpenALAudioDriver::createBuffer(const char* ResRef, short* memory, int size,
+	int channels, int samplerate, unsigned int time_length)
+{
+	ALuint Buffer = 0;
+	CacheEntry *e;
+
+	// make room first, so the new buffer can't be the one evicted
+	evictBuffers(size);
+
+	alGenBuffers(1, &Buffer);
+	if (checkALError("Unable to create sound buffer", ERROR)) {
+		return 0;
+	}
+
+	//it is always reading the stuff into 16 bits
+	alBufferData( Buffer, GetFormatEnum( channels, 16 ), memory, size, samplerate );
 
 	if (checkALError("Unable to fill buffer", ERROR)) {
 		alDeleteBuffers( 1, &Buffer );
@@ -339,14 +498,10 @@ ALuint OpenALAudioDriver::loadSound(const char *ResRef, unsigned int &time_lengt
 
 	e = new CacheEntry;
 	e->Buffer = Buffer;
-	e->Length = ((cnt / riff_chans) * 1000) / samplerate;
+	e->Length = time_length;
 
-	buffercache.SetAt(ResRef, (void*)e);
+	buffercache.SetAt(ResRef, (void*)e, size);
 	//print("LoadSound: added %s to cache: %d. Cache size now %d", ResRef, e->Buffer, buffercache.GetCount());
-
-	if (buffercache.GetCount() > BUFFER_CACHE_SIZE) {
-		evictBuffer();
-	}
 	return Buffer;
 }
 
@@ -365,8 +520,20 @@ Holder<SoundHandle> OpenALAudioDriver::Play(const char* ResRef, int XPos, int YP
 		return Holder<SoundHandle>();
 	}
 
-	Buffer = loadSound( ResRef, time_length );
-	if (Buffer == 0) {
+	// one-shot effects may be decoded in the background and start late,
+	// speech and loops are always waited for
+	bool pending = false;
+	if (decodePool && !(flags & (GEM_SND_SPEECH|GEM_SND_LOOPING))) {
+		Preload(ResRef);
+		Buffer = loadSound( ResRef, time_length, decodeLatency, &pending );
+	} else {
+		Buffer = loadSound( ResRef, time_length );
+	}
+	if (pending && (flags & GEM_SND_SKIP_LATE)) {
+		skippedSounds++;
+		return Holder<SoundHandle>();
+	}
+	if (Buffer == 0 && !pending) {
 		return Holder<SoundHandle>();
 	}
 
@@ -446,7 +613,11 @@ Holder<SoundHandle> OpenALAudioDriver::Play(const char* ResRef, int XPos, int YP
 	stream->Source = Source;
 	stream->free = false;
 
-	if (QueueALBuffer(Source, Buffer) != GEM_OK) {
+	if (pending) {
+		// Update() queues it once the decode is done
+		CopyResRef(stream->pending, ResRef);
+		lateSounds++;
+	} else if (QueueALBuffer(Source, Buffer) != GEM_OK) {
 		return Holder<SoundHandle>();
 	}
 
@@ -454,6 +625,30 @@ Holder<SoundHandle> OpenALAudioDriver::Play(const char* ResRef, int XPos, int YP
 	return stream->handle.get();
 }
 
+void OpenALAudioDriver::Update()
+{
+	if (!decodePool) {
+		return;
+	}
+	for (int i = 0; i < num_streams; i++) {
+		AudioStream& stream = streams[i];
+		if (stream.free || !stream.pending[0]) {
+			continue;
+		}
+
+		unsigned int time_length;
+		bool stillPending = false;
+		ALuint Buffer = loadSound(stream.pending, time_length, 0, &stillPending);
+		if (stillPending) {
+			continue;
+		}
+		stream.pending[0] = 0;
+		if (Buffer == 0 || QueueALBuffer(stream.Source, Buffer) != GEM_OK) {
+			stream.ForceClear();
+		}
+	}
+}
+
 void OpenALAudioDriver::UpdateVolume(unsigned int flags)
 {
 	ieDword volume;
@@ -732,19 +927,15 @@ void OpenALAudioDriver::SetAmbientStreamPitch(int stream, int pitch)
 	checkALError("Unable to set ambient pitch", WARNING);
 }
 
-bool OpenALAudioDriver::evictBuffer()
+// drops the least recently used buffers until size more bytes fit in
+// the cache budget, the caller has to hold bufferMutex
+void OpenALAudioDriver::evictBuffers(size_t size)
 {
-	// Note: this function assumes the caller holds bufferMutex
-
-	// Room for optimization: this is O(n^2) in the number of buffers
-	// at the tail that are used. It can be O(n) if LRUCache supports it.
-
-	unsigned int n = 0;
 	void* p;
 	const char* k;
-	bool res;
+	LRUCache::Iterator it = buffercache.GetLRUIterator();
 
-	while ((res = buffercache.getLRU(n, k, p)) == true) {
+	while (buffercache.GetCount() && buffercache.GetSize() + size > cacheSize && it.Next(k, p)) {
 		CacheEntry* e = (CacheEntry*)p;
 		alDeleteBuffers(1, &e->Buffer);
 		if (alGetError() == AL_NO_ERROR) {
@@ -755,29 +946,23 @@ bool OpenALAudioDriver::evictBuffer()
 			buffercache.Remove(k);
 
 			//print("Removed buffer %s from ACMImp cache", k);
-			break;
 		}
-		++n;
 	}
-
-	return res;
 }
 
 void OpenALAudioDriver::clearBufferCache(bool force)
 {
-	// Room for optimization: any method of iterating over the buffers
-	// would suffice. It doesn't have to be in LRU-order.
 	void* p;
 	const char* k;
-	int n = 0;
-	while (buffercache.getLRU(n, k, p)) {
+	LRUCache::Iterator it = buffercache.GetLRUIterator();
+
+	while (it.Next(k, p)) {
 		CacheEntry* e = (CacheEntry*)p;
 		alDeleteBuffers(1, &e->Buffer);
 		if (force || alGetError() == AL_NO_ERROR) {
 			delete e;
 			buffercache.Remove(k);
-		} else
-			++n;
+		}
 	}
 }
 
@@ -33,6 +33,10 @@
 #include "MusicMgr.h"
 #include "SoundMgr.h"
 #include "System/FileStream.h"
+#include "System/Threading.h"
+
+#include <map>
+#include <string>
 
 #include <SDL.h>
 
@@ -55,7 +59,6 @@
 #endif
 
 #define RETRY 5
-#define BUFFER_CACHE_SIZE 100
 #define MAX_STREAMS 30
 #define MUSICBUFFERS 10
 #define REFERENCE_DISTANCE 50
@@ -78,7 +81,7 @@ public:
 };
 
 struct AudioStream {
-	AudioStream() : Buffer(0), Source(0), Duration(0), free(true), ambient(false), locked(false), delete_buffers(false) { }
+	AudioStream() : Buffer(0), Source(0), Duration(0), free(true), ambient(false), locked(false), delete_buffers(false) { pending[0] = 0; }
 
 	ALuint Buffer;
 	ALuint Source;
@@ -87,6 +90,8 @@ struct AudioStream {
 	bool ambient;
 	bool locked;
 	bool delete_buffers;
+	// an effect waiting for its background decode to finish
+	ieResRef pending;
 
 	void ClearIfStopped();
 	void ClearProcessedBuffers();
@@ -100,6 +105,8 @@ struct CacheEntry {
 	unsigned int Length;
 };
 
+class SoundDecoder;
+
 class OpenALAudioDriver : public Audio {
 public:
 	OpenALAudioDriver(void);
@@ -108,6 +115,8 @@ public:
 	bool Init(void);
 	Holder<SoundHandle> Play(const char* ResRef, int XPos, int YPos,
 					unsigned int flags = 0, unsigned int *length = 0);
+	void Preload(const char* ResRef);
+	void Update();
 	void UpdateVolume(unsigned int flags);
 	bool CanPlay();
 	void ResetMusics();
@@ -128,6 +137,7 @@ public:
 				int channels, short* memory,
 				int size, int samplerate);
 private:
+	friend class SoundDecoder;
 	int QueueALBuffer(ALuint source, ALuint buffer);
 
 private:
@@ -140,10 +150,19 @@ private:
 	LRUCache buffercache;
 	AudioStream speech;
 	AudioStream streams[MAX_STREAMS];
-	ALuint loadSound(const char* ResRef, unsigned int &time_length);
+	ALuint loadSound(const char* ResRef, unsigned int &time_length,
+		int maxWait = -1, bool* pending = NULL);
+	ALuint createBuffer(const char* ResRef, short* memory, int size,
+		int channels, int samplerate, unsigned int time_length);
+	// guards the buffer cache and the background decodes
+	SDL_mutex* bufferMutex;
+	SDL_cond* decodeDone;
+	WorkerPool* decodePool;
+	std::map<std::string, SoundDecoder*> decodes;
+	unsigned int asyncDecodes, lateSounds, skippedSounds;
 	int num_streams;
 	int CountAvailableSources(int limit);
-	bool evictBuffer();
+	void evictBuffers(size_t size);
 	void clearBufferCache(bool force);
 	ALenum GetFormatEnum(int channels, int bits);
 	static int MusicManager(void* args);
@@ -201,6 +201,8 @@ int SDL12VideoDriver::SwapBuffers(void)
 	int ret = SDLVideoDriver::SwapBuffers();
 	backBuf = tmp;
 
+	// the whole backbuffer is presented every frame
+	ClearDirtyRegions();
 	SDL_Flip( disp );
 	return ret;
 }
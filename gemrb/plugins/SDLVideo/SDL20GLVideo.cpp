@@ -725,6 +725,7 @@ int GLVideoDriver::SwapBuffers()
 	SDL_GL_SwapWindow(window);
 	paletteManager->ClearUnused(true);
 	core->RedrawAll();
+	ClearDirtyRegions();
 	spritesPerFrame = 0;
 	return val;
 }
@@ -42,6 +42,7 @@ namespace GemRB
 
 		GLPaletteManager* paletteManager; // palette manager instance
 
+		void DrawCursor() { SDLVideoDriver::DrawCursor(); }
 		void useProgram(GLSLProgram* program); // use this instead program->Use()
 		bool createPrograms();
 		void GLBlitSprite(GLTextureSprite2D* spr, const Region& src, const Region& dst, Palette* attachedPal = NULL, unsigned int flags = 0, const Color* tint = NULL, GLTextureSprite2D* mask = NULL);
@@ -54,6 +55,10 @@ namespace GemRB
 		int SwapBuffers();
 		int CreateDisplay(int w, int h, int b, bool fs, const char* title);
 		bool SupportsBAMSprites() { return false; }
+		bool SupportsConcurrentTiles() { return false; }
+		bool SupportsConcurrentSprites() { return false; }
+		// everything is drawn straight to the screen, nothing to save or composite
+		void PrepareOverlay(const Region& rgn) { Video::PrepareOverlay(rgn); }
 		void BlitSprite(const Sprite2D* spr, const Region& src, const Region& dst, Palette* palette);
 		void BlitGameSprite(const Sprite2D* spr, int x, int y, unsigned int flags, Color tint, SpriteCover* cover, Palette *palette = NULL,	const Region* clip = NULL, bool anchor = false);
 		void BlitTile(const Sprite2D* spr, const Sprite2D* mask, int x, int y, const Region* clip, unsigned int flags);
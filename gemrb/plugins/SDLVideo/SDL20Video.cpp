@@ -41,6 +41,12 @@ SDL20VideoDriver::SDL20VideoDriver(void)
 	renderer = NULL;
 	window = NULL;
 	screenTexture = NULL;
+	for (int i = 0; i < 3; i++) {
+		cursorTextures[i] = NULL;
+		cursorTexturesGrey[i] = false;
+	}
+	uploadBytes = copyBytes = 0;
+	statFrames = 0;
 
 	// touch input
 	ignoreNextFingerUp = 0;
@@ -51,6 +57,9 @@ SDL20VideoDriver::SDL20VideoDriver(void)
 SDL20VideoDriver::~SDL20VideoDriver(void)
 {
 	// no need to call DestroyMovieScreen()
+	for (int i = 0; i < 3; i++) {
+		if (cursorTextures[i]) SDL_DestroyTexture(cursorTextures[i]);
+	}
 	SDL_DestroyTexture(screenTexture);
 	SDL_DestroyRenderer(renderer);
 	SDL_DestroyWindow(window);
@@ -150,7 +159,7 @@ doneFormat:
 		width, height, SDL_GetPixelFormatName(format));
 	backBuf = SDL_CreateRGBSurface( 0, width, height,
 									bpp, r, g, b, a );
-	// tmpBuf is here as a truly ugly hack, so we can copy backBuf to tmpBuf before blitting cursors, and then back again after the screen is presented.
+	// tmpBuf keeps the parts of backBuf covered by tooltips, see PrepareOverlay
 	tmpBuf = SDL_CreateRGBSurface( 0, width, height, bpp, r, g, b, a );
 	this->bpp = bpp;
 
@@ -187,6 +196,21 @@ void SDL20VideoDriver::InitMovieScreen(int &w, int &h, bool yuv)
 	subtitleregion.y = h-h/4;
 }
 
+void SDL20VideoDriver::CopyRegion(SDL_Surface* src, SDL_Surface* dst, const Region& rgn)
+{
+	SDL_Rect srect = RectFromRegion(rgn);
+	SDL_Rect drect = srect;
+	SDL_BlitSurface(src, &srect, dst, &drect);
+}
+
+void SDL20VideoDriver::UpdateTextureRegion(const Region& rgn)
+{
+	SDL_Rect rect = RectFromRegion(rgn);
+	const Uint8* pixels = (const Uint8*) backBuf->pixels;
+	pixels += rgn.y * backBuf->pitch + rgn.x * backBuf->format->BytesPerPixel;
+	SDL_UpdateTexture(screenTexture, &rect, pixels, backBuf->pitch);
+}
+
 void SDL20VideoDriver::DestroyMovieScreen()
 {
 	if (screenTexture) SDL_DestroyTexture(screenTexture);
@@ -198,6 +222,8 @@ void SDL20VideoDriver::DestroyMovieScreen()
 	// destroy any events that took place during the movies
 	SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
 	SDL_RenderClear(renderer); // I guess the videos can potentially be a larger size then the game.
+	// the new texture is empty
+	InvalidateScreen();
 }
 
 void SDL20VideoDriver::showFrame(unsigned char* buf, unsigned int bufw,
@@ -331,16 +357,57 @@ void SDL20VideoDriver::showYUVFrame(unsigned char** buf, unsigned int *strides,
 
 int SDL20VideoDriver::SwapBuffers(void)
 {
-	//this is not pretty. We make a complete copy of the backBuf into tmpBuf, then copy it back after SDLVideoDriver::SwapBuffers has blitted cursors and tooltips, and SDL_UpdateTexture has copied it to the screentexture.
-	if (Cursor[CursorIndex] && !(MouseFlags & (MOUSE_DISABLED | MOUSE_HIDDEN))) {
-		SDL_BlitSurface(backBuf, NULL, tmpBuf, NULL);
-	}
+	bool fullUpdate = dirtyScreen;
+	std::vector<Region> changed;
+	changed.swap(dirtyRegions);
+	ClearDirtyRegions();
+
+	// the cursor is not drawn into backBuf at all and tooltips save
+	// what they cover through PrepareOverlay
+	overlayRegions.clear();
 	int ret = SDLVideoDriver::SwapBuffers();
+	ClearDirtyRegions();
 
-	SDL_UpdateTexture(screenTexture, NULL, backBuf->pixels, backBuf->pitch);
-	if (Cursor[CursorIndex] && !(MouseFlags & (MOUSE_DISABLED | MOUSE_HIDDEN))) {
-		SDL_BlitSurface(tmpBuf, NULL, backBuf, NULL);
+	size_t i;
+	if (!fullUpdate) {
+		// the tooltip of the last frame has to be replaced on screen too
+		for (i = 0; i < changed.size(); i++) {
+			InvalidateRegion(changed[i]);
+		}
+		for (i = 0; i < overlayRegions.size(); i++) {
+			InvalidateRegion(overlayRegions[i]);
+		}
+		for (i = 0; i < lastOverlayRegions.size(); i++) {
+			InvalidateRegion(lastOverlayRegions[i]);
+		}
+		fullUpdate = dirtyScreen;
+	}
+	int bytesPerPixel = backBuf->format->BytesPerPixel;
+	if (fullUpdate) {
+		SDL_UpdateTexture(screenTexture, NULL, backBuf->pixels, backBuf->pitch);
+		uploadBytes += width * height * bytesPerPixel;
+	} else {
+		for (i = 0; i < dirtyRegions.size(); i++) {
+			UpdateTextureRegion(dirtyRegions[i]);
+			uploadBytes += dirtyRegions[i].w * dirtyRegions[i].h * bytesPerPixel;
+		}
+	}
+	ClearDirtyRegions();
+
+	// saved in order, so restore backwards in case the areas overlap
+	for (i = overlayRegions.size(); i--; ) {
+		CopyRegion(tmpBuf, backBuf, overlayRegions[i]);
+		copyBytes += overlayRegions[i].w * overlayRegions[i].h * bytesPerPixel;
 	}
+	lastOverlayRegions.swap(overlayRegions);
+
+	if (++statFrames == 500) {
+		Log(DEBUG, "SDL 2 Driver", "Presenting uploaded %.1f KiB and copied %.1f KiB per frame (%.1f KiB per full frame)",
+			uploadBytes / 1024.0 / statFrames, copyBytes / 1024.0 / statFrames, width * height * bytesPerPixel / 1024.0);
+		uploadBytes = copyBytes = 0;
+		statFrames = 0;
+	}
+
 	/*
 	 Commenting this out because I get better performance (on iOS) with SDL_UpdateTexture
 	 Don't know how universal it is yet so leaving this in commented out just in case
@@ -373,10 +440,141 @@ int SDL20VideoDriver::SwapBuffers(void)
 	 */
 	SDL_RenderClear(renderer);
 	SDL_RenderCopy(renderer, screenTexture, NULL, NULL);
+	if (Cursor[CursorIndex] && !(MouseFlags & (MOUSE_DISABLED | MOUSE_HIDDEN))) {
+		SDL_Texture* cursor = GetCursorTexture();
+		if (cursor) {
+			const Sprite2D* cur = Cursor[CursorIndex];
+			SDL_Rect dst = { CursorPos.x - cur->XPos, CursorPos.y - cur->YPos, cur->Width, cur->Height };
+			SDL_RenderCopy(renderer, cursor, NULL, &dst);
+		}
+	}
 	SDL_RenderPresent( renderer );
 	return ret;
 }
 
+void SDL20VideoDriver::DrawCursor()
+{
+	// composited in SwapBuffers, see GetCursorTexture
+}
+
+void SDL20VideoDriver::RenderCursorSprite(SDL_Surface* surface)
+{
+	const Sprite2D* cur = Cursor[CursorIndex];
+	SDL_Surface* frame = backBuf;
+	Region clip = screenClip;
+	Region area(0, 0, cur->Width, cur->Height);
+
+	// the blitters clip to the screen clip, so it must fit the small surface
+	backBuf = surface;
+	SetScreenClip(&area);
+	if (MouseFlags&MOUSE_GRAYED) {
+		BlitGameSprite(cur, cur->XPos, cur->YPos, BLIT_GREY, fadeColor, NULL, NULL, NULL, true);
+	} else {
+		BlitSprite(cur, cur->XPos, cur->YPos, true);
+	}
+	backBuf = frame;
+	SetScreenClip(&clip);
+}
+
+static inline Uint32 UnpremultiplyChannel(int c, int alpha)
+{
+	int v = (c * 255 + alpha / 2) / alpha;
+	return v > 255 ? 255 : v;
+}
+
+SDL_Texture* SDL20VideoDriver::GetCursorTexture()
+{
+	bool grey = (MouseFlags & MOUSE_GRAYED) != 0;
+	if (cursorTextures[CursorIndex]) {
+		if (cursorTexturesGrey[CursorIndex] == grey) {
+			return cursorTextures[CursorIndex];
+		}
+		SDL_DestroyTexture(cursorTextures[CursorIndex]);
+		cursorTextures[CursorIndex] = NULL;
+	}
+
+	// The cursor is rendered with the regular blitters once over black and
+	// once over white. The difference between the two gives the alpha of
+	// each pixel, so transparency and blending come out just as before.
+	const Sprite2D* cur = Cursor[CursorIndex];
+	SDL_PixelFormat* fmt = backBuf->format;
+	SDL_Surface* black = SDL_CreateRGBSurface(0, cur->Width, cur->Height, fmt->BitsPerPixel,
+											  fmt->Rmask, fmt->Gmask, fmt->Bmask, 0);
+	SDL_Surface* white = SDL_CreateRGBSurface(0, cur->Width, cur->Height, fmt->BitsPerPixel,
+											  fmt->Rmask, fmt->Gmask, fmt->Bmask, 0);
+	SDL_Surface* cursor = SDL_CreateRGBSurface(0, cur->Width, cur->Height, 32,
+											   0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000);
+	if (!black || !white || !cursor) {
+		Log(ERROR, "SDL 2 Driver", "Unable to create cursor surfaces: %s", SDL_GetError());
+		SDL_FreeSurface(black);
+		SDL_FreeSurface(white);
+		SDL_FreeSurface(cursor);
+		return NULL;
+	}
+	SDL_FillRect(black, NULL, SDL_MapRGB(black->format, 0, 0, 0));
+	SDL_FillRect(white, NULL, SDL_MapRGB(white->format, 0xff, 0xff, 0xff));
+	RenderCursorSprite(black);
+	RenderCursorSprite(white);
+
+	for (int y = 0; y < cur->Height; y++) {
+		Uint32* out = (Uint32*)((Uint8*)cursor->pixels + y * cursor->pitch);
+		for (int x = 0; x < cur->Width; x++) {
+			Color b, w;
+			GetSurfacePixel(black, x, y, b);
+			GetSurfacePixel(white, x, y, w);
+			// over black: a*c, over white: a*c + (1-a)*255
+			// every channel carries the same alpha, so average them to
+			// even out the rounding of 16 bit surfaces
+			int diff = (w.r - b.r) + (w.g - b.g) + (w.b - b.b);
+			int alpha = 255 - (diff + 1) / 3;
+			if (alpha <= 0) {
+				out[x] = 0;
+				continue;
+			}
+			if (alpha > 255) alpha = 255;
+			Uint32 r = UnpremultiplyChannel(b.r, alpha);
+			Uint32 g = UnpremultiplyChannel(b.g, alpha);
+			Uint32 bl = UnpremultiplyChannel(b.b, alpha);
+			out[x] = ((Uint32) alpha << 24) | (r << 16) | (g << 8) | bl;
+		}
+	}
+
+	SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, cursor);
+	if (tex) {
+		SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+	} else {
+		Log(ERROR, "SDL 2 Driver", "Unable to create cursor texture: %s", SDL_GetError());
+	}
+	SDL_FreeSurface(black);
+	SDL_FreeSurface(white);
+	SDL_FreeSurface(cursor);
+
+	cursorTextures[CursorIndex] = tex;
+	cursorTexturesGrey[CursorIndex] = grey;
+	return tex;
+}
+
+void SDL20VideoDriver::SetCursor(Sprite2D* cur, enum CursorType curIdx)
+{
+	if (cursorTextures[curIdx]) {
+		SDL_DestroyTexture(cursorTextures[curIdx]);
+		cursorTextures[curIdx] = NULL;
+	}
+	SDLVideoDriver::SetCursor(cur, curIdx);
+}
+
+void SDL20VideoDriver::PrepareOverlay(const Region& rgn)
+{
+	Region r = rgn.Intersect(Region(0, 0, width, height));
+	if (r.w <= 0 || r.h <= 0) {
+		return;
+	}
+	// save what the tooltip covers, SwapBuffers puts it back after presenting
+	CopyRegion(backBuf, tmpBuf, r);
+	copyBytes += r.w * r.h * backBuf->format->BytesPerPixel;
+	overlayRegions.push_back(r);
+}
+
 int SDL20VideoDriver::PollEvents()
 {
 	if (ignoreNextFingerUp <= 0
@@ -804,6 +1002,7 @@ bool SDL20VideoDriver::SetFullscreenMode(bool set)
 	}
 	if (SDL_SetWindowFullscreen(window, flags) == GEM_OK) {
 		fullscreen = set;
+		InvalidateScreen();
 		return true;
 	}
 	return false;
@@ -51,6 +51,15 @@ protected:
 	SDL_Window* window;
 	SDL_Texture* screenTexture;
 	SDL_Renderer* renderer;
+	// the cursor is composited at present time, one texture per cursor type
+	SDL_Texture* cursorTextures[3];
+	bool cursorTexturesGrey[3];
+	// areas covered by tooltips in this and the last frame
+	std::vector<Region> overlayRegions;
+	std::vector<Region> lastOverlayRegions;
+	// bytes uploaded to the screen texture and copied around tooltips
+	unsigned __int64 uploadBytes, copyBytes;
+	unsigned int statFrames;
 public:
 	SDL20VideoDriver(void);
 	~SDL20VideoDriver(void);
@@ -73,6 +82,9 @@ public:
 					  unsigned int dstx, unsigned int dsty,
 					  ieDword titleref);
 
+	void SetCursor(Sprite2D* cur, enum CursorType curIdx);
+	void PrepareOverlay(const Region& rgn);
+
 	bool SetFullscreenMode(bool set);
 	void SetGamma(int brightness, int contrast);
 	bool ToggleGrabInput();
@@ -81,6 +93,11 @@ public:
 	void MoveMouse(unsigned int x, unsigned int y);
 private:
 	bool SetSurfaceAlpha(SDL_Surface* surface, unsigned short alpha);
+	void CopyRegion(SDL_Surface* src, SDL_Surface* dst, const Region& rgn);
+	void UpdateTextureRegion(const Region& rgn);
+	void DrawCursor();
+	SDL_Texture* GetCursorTexture();
+	void RenderCursorSprite(SDL_Surface* surface);
 
 	int ProcessEvent(const SDL_Event & event);
 	// the first finger touch of a gesture is delayed until another touch event or until
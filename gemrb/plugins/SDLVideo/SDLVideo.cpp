@@ -21,6 +21,7 @@
 #include "SDLVideo.h"
 #include "SDLSurfaceSprite2D.h"
 
+#include "SIMDRenderer.inl"
 #include "TileRenderer.inl"
 #include "SpriteRenderer.inl"
 
@@ -116,13 +117,7 @@ int SDLVideoDriver::SwapBuffers(void)
 	lastTime = time;
 
 	if (Cursor[CursorIndex] && !(MouseFlags & (MOUSE_DISABLED | MOUSE_HIDDEN))) {
-		
-		if (MouseFlags&MOUSE_GRAYED) {
-			//used for greyscale blitting, fadeColor is unused
-			BlitGameSprite(Cursor[CursorIndex], CursorPos.x, CursorPos.y, BLIT_GREY, fadeColor, NULL, NULL, NULL, true);
-		} else {
-			BlitSprite(Cursor[CursorIndex], CursorPos.x, CursorPos.y, true);
-		}
+		DrawCursor();
 	}
 	if (!(MouseFlags & MOUSE_NO_TOOLTIPS)) {
 		//handle tooltips
@@ -143,6 +138,18 @@ int SDLVideoDriver::SwapBuffers(void)
 	return PollEvents();
 }
 
+void SDLVideoDriver::DrawCursor()
+{
+	const Sprite2D* cur = Cursor[CursorIndex];
+	if (MouseFlags&MOUSE_GRAYED) {
+		//used for greyscale blitting, fadeColor is unused
+		BlitGameSprite(cur, CursorPos.x, CursorPos.y, BLIT_GREY, fadeColor, NULL, NULL, NULL, true);
+	} else {
+		BlitSprite(cur, CursorPos.x, CursorPos.y, true);
+	}
+	InvalidateRegion(Region(CursorPos.x - cur->XPos, CursorPos.y - cur->YPos, cur->Width, cur->Height));
+}
+
 int SDLVideoDriver::PollEvents()
 {
 	int ret = GEM_OK;
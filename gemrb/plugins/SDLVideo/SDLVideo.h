@@ -55,10 +55,9 @@ class SDLVideoDriver : public Video {
 protected:
 	SDL_Surface* disp;
 	SDL_Surface* backBuf;
-	// tmpBuf is here as a truly ugly hack, so we can copy backBuf to tmpBuf before blitting cursors, and then back again after the screen is presented. Only applies for SDL2.
+	// tmpBuf holds what tooltips are drawn over, so it can be restored after the screen is presented. Only applies for SDL2.
 	SDL_Surface* tmpBuf;
 	SDL_Surface* extra;
-	std::vector< Region> upd;//Regions of the Screen to Update in the next SwapBuffer operation.
 	unsigned long lastTime;
 	unsigned long lastMouseMoveTime;
 	unsigned long lastMouseDownTime;
@@ -98,6 +97,8 @@ public:
 								   Color* palette, bool cK = false, int index = 0);
 
 	virtual bool SupportsBAMSprites() { return true; }
+	virtual bool SupportsConcurrentTiles() { return true; }
+	virtual bool SupportsConcurrentSprites() { return true; }
 
 	virtual void BlitTile(const Sprite2D* spr, const Sprite2D* mask, int x, int y,
 						  const Region* clip, unsigned int flags);
@@ -168,6 +169,8 @@ protected:
 	virtual bool SetSurfaceAlpha(SDL_Surface* surface, unsigned short alpha)=0;
 	/* used to process the SDL events dequeued by PollEvents or an arbitraty event from another source.*/
 	virtual int ProcessEvent(const SDL_Event & event);
+	/* draws the mouse cursor into the backbuffer, called by SwapBuffers */
+	virtual void DrawCursor();
 
 public:
 	// static functions for manipulating surfaces
@@ -0,0 +1,279 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2016 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+// Span kernels shared by the tile and sprite renderers.
+// Each kernel has a scalar version and, where the compiler supports it,
+// an SSE2 version that is selected at runtime. Both must produce exactly
+// the same pixels.
+
+// For debugging:
+// check every SSE2 span against the scalar version
+//#define VALIDATE_SIMD
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#include <cstring>
+#ifdef VALIDATE_SIMD
+#include <cassert>
+#endif
+
+namespace {
+using namespace GemRB;
+
+// longest span handed to the kernels at once (a tile row)
+const int SPAN_MAX = 64;
+
+#ifdef SIMD_SSE2
+static const bool UseSSE2 = SDL_HasSSE2();
+#endif
+
+// dst[i] = src[i] wherever mask[i] == key
+template<typename PixelType>
+static void SpanMaskedCopy_scalar(PixelType* dst, const PixelType* src,
+                                  const Uint8* mask, Uint8 key, int n)
+{
+	for (int i = 0; i < n; ++i) {
+		if (mask[i] == key)
+			dst[i] = src[i];
+	}
+}
+
+// average of two pixels, halfmask clears the bits shifted into the
+// neighbouring channel
+template<typename PixelType>
+static void SpanHalfBlend_scalar(PixelType* dst, const PixelType* src,
+                                 int n, Uint32 halfmask)
+{
+	for (int i = 0; i < n; ++i) {
+		dst[i] = (PixelType)(((dst[i] >> 1) & halfmask) + ((src[i] >> 1) & halfmask));
+	}
+}
+
+// 32 bpp alpha blend of the channels in rgbmask, the remaining byte is cleared
+static void SpanAlphaBlend32_scalar(Uint32* dst, const Uint32* src,
+                                    const Uint8* alpha, int n, Uint32 rgbmask)
+{
+	for (int i = 0; i < n; ++i) {
+		unsigned int a = alpha[i];
+		Uint32 out = 0;
+		for (unsigned int shift = 0; shift < 32; shift += 8) {
+			unsigned int s = (src[i] >> shift) & 0xFF;
+			unsigned int d = (dst[i] >> shift) & 0xFF;
+			unsigned int c = 1 + a*s + (255-a)*d;
+			out |= ((c + (c>>8)) >> 8) << shift;
+		}
+		dst[i] = out & rgbmask;
+	}
+}
+
+#ifdef SIMD_SSE2
+
+// The SSE2 kernels return how many pixels they handled,
+// the scalar version takes care of the tail.
+
+static int SpanMaskedCopy_sse2(Uint32* dst, const Uint32* src,
+                               const Uint8* mask, Uint8 key, int n)
+{
+	const __m128i keys = _mm_set1_epi8((char)key);
+	int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		Uint32 m4;
+		memcpy(&m4, mask + i, 4);
+		__m128i m = _mm_cmpeq_epi8(_mm_cvtsi32_si128((int)m4), keys);
+		m = _mm_unpacklo_epi8(m, m);
+		m = _mm_unpacklo_epi16(m, m);
+		__m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+		__m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+		d = _mm_or_si128(_mm_and_si128(m, s), _mm_andnot_si128(m, d));
+		_mm_storeu_si128((__m128i*)(dst + i), d);
+	}
+	return i;
+}
+
+static int SpanMaskedCopy_sse2(Uint16* dst, const Uint16* src,
+                               const Uint8* mask, Uint8 key, int n)
+{
+	const __m128i keys = _mm_set1_epi8((char)key);
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m128i m = _mm_cmpeq_epi8(_mm_loadl_epi64((const __m128i*)(mask + i)), keys);
+		m = _mm_unpacklo_epi8(m, m);
+		__m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+		__m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+		d = _mm_or_si128(_mm_and_si128(m, s), _mm_andnot_si128(m, d));
+		_mm_storeu_si128((__m128i*)(dst + i), d);
+	}
+	return i;
+}
+
+static int SpanHalfBlend_sse2(Uint32* dst, const Uint32* src, int n, Uint32 halfmask)
+{
+	const __m128i hm = _mm_set1_epi32((int)halfmask);
+	int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+		__m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+		d = _mm_add_epi32(_mm_and_si128(_mm_srli_epi32(d, 1), hm),
+		                  _mm_and_si128(_mm_srli_epi32(s, 1), hm));
+		_mm_storeu_si128((__m128i*)(dst + i), d);
+	}
+	return i;
+}
+
+static int SpanHalfBlend_sse2(Uint16* dst, const Uint16* src, int n, Uint32 halfmask)
+{
+	const __m128i hm = _mm_set1_epi16((short)halfmask);
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+		__m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+		d = _mm_add_epi16(_mm_and_si128(_mm_srli_epi16(d, 1), hm),
+		                  _mm_and_si128(_mm_srli_epi16(s, 1), hm));
+		_mm_storeu_si128((__m128i*)(dst + i), d);
+	}
+	return i;
+}
+
+// s, d and a hold one channel per 16 bit lane; no intermediate exceeds 16 bits
+static inline __m128i AlphaBlendLanes(__m128i s, __m128i d, __m128i a)
+{
+	const __m128i one = _mm_set1_epi16(1);
+	const __m128i full = _mm_set1_epi16(255);
+	__m128i c = _mm_add_epi16(_mm_mullo_epi16(s, a),
+	                          _mm_mullo_epi16(d, _mm_sub_epi16(full, a)));
+	c = _mm_add_epi16(c, one);
+	return _mm_srli_epi16(_mm_add_epi16(c, _mm_srli_epi16(c, 8)), 8);
+}
+
+static int SpanAlphaBlend32_sse2(Uint32* dst, const Uint32* src,
+                                 const Uint8* alpha, int n, Uint32 rgbmask)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i keep = _mm_set1_epi32((int)rgbmask);
+	int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		Uint32 a4;
+		memcpy(&a4, alpha + i, 4);
+		// spread each pixel's alpha over its four channel lanes
+		__m128i a = _mm_unpacklo_epi8(_mm_cvtsi32_si128((int)a4), zero);
+		a = _mm_unpacklo_epi16(a, a);
+		__m128i alo = _mm_unpacklo_epi32(a, a);
+		__m128i ahi = _mm_unpackhi_epi32(a, a);
+
+		__m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+		__m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+		__m128i lo = AlphaBlendLanes(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), alo);
+		__m128i hi = AlphaBlendLanes(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), ahi);
+		d = _mm_and_si128(_mm_packus_epi16(lo, hi), keep);
+		_mm_storeu_si128((__m128i*)(dst + i), d);
+	}
+	return i;
+}
+
+#endif
+
+#ifdef VALIDATE_SIMD
+template<typename PixelType>
+static void SpanValidate(const char* kernel, const PixelType* result, const PixelType* expected, int n)
+{
+	for (int i = 0; i < n; ++i) {
+		if (result[i] != expected[i]) {
+			Log(ERROR, "SDLVideo", "%s: pixel %d of %d differs (%x instead of %x)",
+				kernel, i, n, (unsigned int) result[i], (unsigned int) expected[i]);
+			assert(false);
+		}
+	}
+}
+#endif
+
+template<typename PixelType>
+static inline void SpanMaskedCopy(PixelType* dst, const PixelType* src,
+                                  const Uint8* mask, Uint8 key, int n)
+{
+	int done = 0;
+#ifdef SIMD_SSE2
+	if (UseSSE2) {
+#ifdef VALIDATE_SIMD
+		assert(n <= SPAN_MAX);
+		PixelType expected[SPAN_MAX];
+		memcpy(expected, dst, n*sizeof(PixelType));
+		SpanMaskedCopy_scalar(expected, src, mask, key, n);
+#endif
+		done = SpanMaskedCopy_sse2(dst, src, mask, key, n);
+#ifdef VALIDATE_SIMD
+		SpanMaskedCopy_scalar(dst + done, src + done, mask + done, key, n - done);
+		SpanValidate("SpanMaskedCopy", dst, expected, n);
+		return;
+#endif
+	}
+#endif
+	SpanMaskedCopy_scalar(dst + done, src + done, mask + done, key, n - done);
+}
+
+template<typename PixelType>
+static inline void SpanHalfBlend(PixelType* dst, const PixelType* src, int n, Uint32 halfmask)
+{
+	int done = 0;
+#ifdef SIMD_SSE2
+	if (UseSSE2) {
+#ifdef VALIDATE_SIMD
+		assert(n <= SPAN_MAX);
+		PixelType expected[SPAN_MAX];
+		memcpy(expected, dst, n*sizeof(PixelType));
+		SpanHalfBlend_scalar(expected, src, n, halfmask);
+#endif
+		done = SpanHalfBlend_sse2(dst, src, n, halfmask);
+#ifdef VALIDATE_SIMD
+		SpanHalfBlend_scalar(dst + done, src + done, n - done, halfmask);
+		SpanValidate("SpanHalfBlend", dst, expected, n);
+		return;
+#endif
+	}
+#endif
+	SpanHalfBlend_scalar(dst + done, src + done, n - done, halfmask);
+}
+
+static inline void SpanAlphaBlend32(Uint32* dst, const Uint32* src,
+                                    const Uint8* alpha, int n, Uint32 rgbmask)
+{
+	int done = 0;
+#ifdef SIMD_SSE2
+	if (UseSSE2) {
+#ifdef VALIDATE_SIMD
+		assert(n <= SPAN_MAX);
+		Uint32 expected[SPAN_MAX];
+		memcpy(expected, dst, n*sizeof(Uint32));
+		SpanAlphaBlend32_scalar(expected, src, alpha, n, rgbmask);
+#endif
+		done = SpanAlphaBlend32_sse2(dst, src, alpha, n, rgbmask);
+#ifdef VALIDATE_SIMD
+		SpanAlphaBlend32_scalar(dst + done, src + done, alpha + done, n - done, rgbmask);
+		SpanValidate("SpanAlphaBlend32", dst, expected, n);
+		return;
+#endif
+	}
+#endif
+	SpanAlphaBlend32_scalar(dst + done, src + done, alpha + done, n - done, rgbmask);
+}
+
+}
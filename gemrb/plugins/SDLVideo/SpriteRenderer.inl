@@ -292,6 +292,153 @@ struct SRBlender<Uint32, SRBlender_Alpha, SRFormat_Hard> {
 };
 
 
+// Gathers the pixels a blit writes next to each other, so the blender can
+// process them as a span with the kernels from SIMDRenderer.inl.
+// Pixels that aren't adjacent to the previous one start a new span.
+// The default passes every pixel straight to the blender.
+template<typename PTYPE, typename Blender>
+struct SRSpan {
+	SRSpan(const Blender& b, int) : blend(b) { }
+
+	void operator()(PTYPE& pix, Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+		blend(pix, r, g, b, a);
+	}
+	void Flush() { }
+
+	const Blender& blend;
+};
+
+template<typename PTYPE>
+struct SRSpanBuffer {
+	// dir is -1 if the blit goes right to left
+	SRSpanBuffer(int dir) : start(NULL), count(0), step(dir) { }
+
+	// returns the span to blend, with the pixels in ascending order
+	PTYPE* Collect(PTYPE& pix) {
+		if (count && (count == SPAN_MAX || &pix != start + count*step)) {
+			return Finish();
+		}
+		return NULL;
+	}
+
+	void Add(PTYPE& pix, PTYPE p, Uint8 a) {
+		if (!count) start = &pix;
+		src[count] = p;
+		alpha[count] = a;
+		count++;
+	}
+
+	PTYPE* Finish() {
+		PTYPE* dst = start;
+		if (step < 0) {
+			dst = start - count + 1;
+			for (int i = 0, j = count - 1; i < j; ++i, --j) {
+				PTYPE tp = src[i]; src[i] = src[j]; src[j] = tp;
+				Uint8 ta = alpha[i]; alpha[i] = alpha[j]; alpha[j] = ta;
+			}
+		}
+		return dst;
+	}
+
+	PTYPE* start;
+	int count;
+	const int step;
+	PTYPE src[SPAN_MAX];
+	Uint8 alpha[SPAN_MAX];
+};
+
+template<typename PTYPE>
+static inline PTYPE SRPack(Uint8 r, Uint8 g, Uint8 b);
+
+template<>
+inline Uint16 SRPack<Uint16>(Uint8 r, Uint8 g, Uint8 b) {
+	return ((r >> RLOSS16) << RSHIFT16) |
+	       ((g >> GLOSS16) << GSHIFT16) |
+	       ((b >> BLOSS16) << BSHIFT16);
+}
+
+template<>
+inline Uint32 SRPack<Uint32>(Uint8 r, Uint8 g, Uint8 b) {
+	return (r << RSHIFT32) | (g << GSHIFT32) | (b << BSHIFT32);
+}
+
+template<typename PTYPE>
+struct SRSpan<PTYPE, SRBlender<PTYPE, SRBlender_NoAlpha, SRFormat_Hard> > {
+	SRSpan(const SRBlender<PTYPE, SRBlender_NoAlpha, SRFormat_Hard>&, int step) : buf(step) { }
+
+	void operator()(PTYPE& pix, Uint8 r, Uint8 g, Uint8 b, Uint8) {
+		PTYPE* dst = buf.Collect(pix);
+		if (dst) Blend(dst);
+		buf.Add(pix, SRPack<PTYPE>(r, g, b), 0);
+	}
+	void Flush() {
+		if (buf.count) Blend(buf.Finish());
+	}
+	void Blend(PTYPE* dst) {
+		memcpy(dst, buf.src, buf.count*sizeof(PTYPE));
+		buf.count = 0;
+	}
+
+	SRSpanBuffer<PTYPE> buf;
+};
+
+template<typename PTYPE>
+struct SRSpan<PTYPE, SRBlender<PTYPE, SRBlender_HalfAlpha, SRFormat_Hard> > {
+	SRSpan(const SRBlender<PTYPE, SRBlender_HalfAlpha, SRFormat_Hard>&, int step) : buf(step) { }
+
+	void operator()(PTYPE& pix, Uint8 r, Uint8 g, Uint8 b, Uint8) {
+		PTYPE* dst = buf.Collect(pix);
+		if (dst) Blend(dst);
+		buf.Add(pix, SRPack<PTYPE>(r, g, b), 0);
+	}
+	void Flush() {
+		if (buf.count) Blend(buf.Finish());
+	}
+	void Blend(PTYPE* dst) {
+		SpanHalfBlend(dst, buf.src, buf.count, sizeof(PTYPE) == 4 ? halfmask32 : halfmask16);
+		buf.count = 0;
+	}
+
+	SRSpanBuffer<PTYPE> buf;
+};
+
+// only 32 bpp alpha blending has a span kernel, 16 bpp uses the default
+template<>
+struct SRSpan<Uint32, SRBlender<Uint32, SRBlender_Alpha, SRFormat_Hard> > {
+	SRSpan(const SRBlender<Uint32, SRBlender_Alpha, SRFormat_Hard>&, int step) : buf(step) { }
+
+	void operator()(Uint32& pix, Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+		Uint32* dst = buf.Collect(pix);
+		if (dst) Blend(dst);
+		buf.Add(pix, SRPack<Uint32>(r, g, b), a);
+	}
+	void Flush() {
+		if (buf.count) Blend(buf.Finish());
+	}
+	void Blend(Uint32* dst) {
+		SpanAlphaBlend32(dst, buf.src, buf.alpha, buf.count,
+		                 (0xFFU << RSHIFT32) | (0xFFU << GSHIFT32) | (0xFFU << BSHIFT32));
+		buf.count = 0;
+	}
+
+	SRSpanBuffer<Uint32> buf;
+};
+
+// Tinting only depends on the palette entry, so for anything but tiny blits
+// it is cheaper to tint the palette once than every pixel.
+template<typename Tinter>
+static const Color* SRTintPalette(Color* tcol, const Color* col, const Region& clip,
+                                  const Tinter& tint, unsigned int flags)
+{
+	if (clip.w * clip.h <= 256) return NULL;
+
+	for (int i = 0; i < 256; ++i) {
+		tcol[i] = col[i];
+		tint(tcol[i].r, tcol[i].g, tcol[i].b, tcol[i].a, flags);
+	}
+	return tcol;
+}
+
 // MSVC6 requires all template arguments to a function to be reflected in the
 // argument list. We wrap them in the type of a dummy argument.
 template <bool b>
@@ -393,6 +540,10 @@ static void BlitSpriteRLE_internal(SDL_Surface* target,
 	const int yfactor = yflip ? -1 : 1;
 	const int xfactor = XFLIP ? -1 : 1;
 
+	Color tintedcol[256];
+	const Color* tcol = SRTintPalette(tintedcol, col, clip, tint, flags);
+	SRSpan<PTYPE, Blender> span(blend, xfactor);
+
 	while (line != end) {
 
 		// Fast-forward through the RLE data until we reach clipstartpix
@@ -445,12 +596,16 @@ static void BlitSpriteRLE_internal(SDL_Surface* target,
 					if (!COVER || !*coverpix) {
 						int extra_alpha = 0;
 						if (!shadow(*pix, p, extra_alpha, flags)) {
-							Uint8 r = col[p].r;
-							Uint8 g = col[p].g;
-							Uint8 b = col[p].b;
-							Uint8 a = col[p].a;
-							tint(r, g, b, a, flags);
-							blend(*pix, r, g, b, a >> extra_alpha);
+							if (tcol) {
+								span(*pix, tcol[p].r, tcol[p].g, tcol[p].b, tcol[p].a >> extra_alpha);
+							} else {
+								Uint8 r = col[p].r;
+								Uint8 g = col[p].g;
+								Uint8 b = col[p].b;
+								Uint8 a = col[p].a;
+								tint(r, g, b, a, flags);
+								span(*pix, r, g, b, a >> extra_alpha);
+							}
 						}
 					}
 #ifdef HIGHLIGHTCOVER
@@ -480,6 +635,7 @@ static void BlitSpriteRLE_internal(SDL_Surface* target,
 		clipstartpix += yfactor * pitch;
 		clipendpix += yfactor * pitch;
 	}
+	span.Flush();
 
 }
 
@@ -559,6 +715,10 @@ static void BlitSprite_internal(SDL_Surface* target,
 	const int yfactor = yflip ? -1 : 1;
 	const int xfactor = XFLIP ? -1 : 1;
 
+	Color tintedcol[256];
+	const Color* tcol = SRTintPalette(tintedcol, col, clip, tint, flags);
+	SRSpan<PTYPE, Blender> span(blend, xfactor);
+
 	while (line != end) {
 		do {
 			Uint8 p = *srcdata++;
@@ -566,12 +726,16 @@ static void BlitSprite_internal(SDL_Surface* target,
 				if (!COVER || !*coverpix) {
 					int extra_alpha = 0;
 					if (!shadow(*pix, p, extra_alpha, flags)) {
-						Uint8 r = col[p].r;
-						Uint8 g = col[p].g;
-						Uint8 b = col[p].b;
-						Uint8 a = col[p].a;
-						tint(r, g, b, a, flags);
-						blend(*pix, r, g, b, a >> extra_alpha);
+						if (tcol) {
+							span(*pix, tcol[p].r, tcol[p].g, tcol[p].b, tcol[p].a >> extra_alpha);
+						} else {
+							Uint8 r = col[p].r;
+							Uint8 g = col[p].g;
+							Uint8 b = col[p].b;
+							Uint8 a = col[p].a;
+							tint(r, g, b, a, flags);
+							span(*pix, r, g, b, a >> extra_alpha);
+						}
 					}
 				}
 #ifdef HIGHLIGHTCOVER
@@ -597,6 +761,7 @@ static void BlitSprite_internal(SDL_Surface* target,
 		if (COVER)
 			coverpix += yfactor * cover->Width - xfactor * clip.w;
 	}
+	span.Flush();
 
 }
 
@@ -674,6 +839,7 @@ static void BlitSpriteRGB_internal(SDL_Surface* target,
 
 	const int yfactor = yflip ? -1 : 1;
 	const int xfactor = XFLIP ? -1 : 1;
+	SRSpan<PTYPE, Blender> span(blend, xfactor);
 
 	while (line != end) {
 		do {
@@ -685,7 +851,7 @@ static void BlitSpriteRGB_internal(SDL_Surface* target,
 					Uint8 g = (Uint8)(p >> 8);
 					Uint8 b = (Uint8)(p >> 16);
 					tint(r, g, b, a, flags);
-					blend(*pix, r, g, b, a);
+					span(*pix, r, g, b, a);
 				}
 #ifdef HIGHLIGHTCOVER
 				else if (COVER) {
@@ -710,6 +876,7 @@ static void BlitSpriteRGB_internal(SDL_Surface* target,
 		if (COVER)
 			coverpix += yfactor * cover->Width - xfactor * clip.w;
 	}
+	span.Flush();
 
 }
 
@@ -66,11 +66,19 @@ struct TRTinter_Sepia {
 	Color tint;
 };
 
+// The blenders work on whole rows: line holds the palette-converted
+// tile pixels and buf the matching part of the target surface.
 struct TRBlender_Opaque {
 	TRBlender_Opaque(const SDL_PixelFormat*) { }
 
-	Uint32 operator()(Uint32 p, Uint32) const {
-		return p;
+	template<typename PixelType>
+	void Row(PixelType* buf, const PixelType* line, int w) const {
+		memcpy(buf, line, w*sizeof(PixelType));
+	}
+
+	template<typename PixelType>
+	void MaskedRow(PixelType* buf, const PixelType* line, const Uint8* mask, Uint8 mask_key, int w) const {
+		SpanMaskedCopy(buf, line, mask, mask_key, w);
 	}
 };
 
@@ -82,8 +90,16 @@ struct TRBlender_HalfTrans {
 				| (0x7F >> format->Bloss) << format->Bshift;
 	}
 
-	Uint32 operator()(Uint32 p, Uint32 v) const {
-		return ((p>>1)&mask) + ((v >> 1)&mask);
+	template<typename PixelType>
+	void Row(PixelType* buf, const PixelType* line, int w) const {
+		SpanHalfBlend(buf, line, w, mask);
+	}
+
+	template<typename PixelType>
+	void MaskedRow(PixelType* buf, PixelType* line, const Uint8* mask_line, Uint8 mask_key, int w) const {
+		// the blend is symmetric, so blend into line and copy what isn't masked
+		SpanHalfBlend(line, buf, w, mask);
+		SpanMaskedCopy(buf, line, mask_line, mask_key, w);
 	}
 
 	Uint32 mask;
@@ -117,38 +133,23 @@ static void BlitTile_internal(SDL_Surface* target,
 		                   | (b >> target->format->Bloss) << target->format->Bshift;
 	}
 
-	if (mask) {
-		const Uint8* mask_line = mask + ry*64;
-		for (int y = 0; y < h; ++y) {
-			PixelType* buf = buf_line + tx + rx;
-			data = data_line + rx;
-			mask = mask_line + rx;
-			for (int x = 0; x < w; ++x) {
-				Uint8 p = *data++;
-				Uint8 m = *mask++;
-				if (m == mask_key)
-					*buf = (PixelType)blend(opal[p],*buf);
-				buf++;
-			}
-			buf_line += target->pitch / sizeof(PixelType);
-			mask_line += 64;
-			data_line += 64;
-		}
+	PixelType line[64];
+	const Uint8* mask_line = mask ? mask + ry*64 : NULL;
 
-	} else {
-
-		for (int y = 0; y < h; ++y) {
-			PixelType* buf = buf_line + tx + rx;
-			data = data_line + rx;
-			for (int x = 0; x < w; ++x) {
-				Uint8 p = *data++;
-				*buf = (PixelType)blend(opal[p],*buf);
-				buf++;
-			}
-			buf_line += target->pitch / sizeof(PixelType);
-			data_line += 64;
+	for (int y = 0; y < h; ++y) {
+		PixelType* buf = buf_line + tx + rx;
+		data = data_line + rx;
+		for (int x = 0; x < w; ++x) {
+			line[x] = opal[data[x]];
 		}
-
+		if (mask_line) {
+			blend.MaskedRow(buf, line, mask_line + rx, mask_key, w);
+			mask_line += 64;
+		} else {
+			blend.Row(buf, line, w);
+		}
+		buf_line += target->pitch / sizeof(PixelType);
+		data_line += 64;
 	}
 }
 
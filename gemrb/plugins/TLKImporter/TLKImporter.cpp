@@ -33,6 +33,9 @@
 
 using namespace GemRB;
 
+// memory the converted strings may take up, in bytes
+#define STRING_CACHE_SIZE (256 * 1024)
+
 //set this to -1 if charname is gabber (iwd2)
 static int charname=0;
 struct gt_type
@@ -58,6 +61,8 @@ TLKImporter::TLKImporter(void)
 	str = NULL;
 	override = NULL;
 	StrRefCount = Offset = 0;
+	stringCacheSize = 0;
+	cacheHits = cacheMisses = 0;
 
 	AutoTable tm("gender");
 	if (tm) {
@@ -84,6 +89,11 @@ static void ReleaseGtEntry(void *poi)
 
 TLKImporter::~TLKImporter(void)
 {
+	if (cacheHits || cacheMisses) {
+		Log(DEBUG, "TLKImporter", "String cache: %u hits, %u misses, %lu bytes in %lu strings.",
+			cacheHits, cacheMisses, (unsigned long) stringCacheSize, (unsigned long) stringCache.size());
+	}
+	ClearStringCache();
 	delete str;
 	
 	gtmap.RemoveAll(ReleaseGtEntry);
@@ -127,9 +137,37 @@ bool TLKImporter::Open(DataStream* stream)
 	str->Seek( 2, GEM_CURRENT_POS );
 	str->ReadDword( &StrRefCount );
 	str->ReadDword( &Offset );
+
+	ClearStringCache();
+	entries.clear();
+	entries.reserve(StrRefCount);
+	for (ieDword i = 0; i < StrRefCount; i++) {
+		TLKEntry entry;
+		ieDword Volume, Pitch;
+		if (str->ReadWord( &entry.type ) == GEM_ERROR) {
+			break;
+		}
+		str->ReadResRef( entry.SoundResRef );
+		str->ReadDword( &Volume );
+		str->ReadDword( &Pitch );
+		str->ReadDword( &entry.StrOffset );
+		str->ReadDword( &entry.Length );
+		entries.push_back( entry );
+	}
 	return true;
 }
 
+void TLKImporter::ClearStringCache()
+{
+	StringCache::iterator it;
+	for (it = stringCache.begin(); it != stringCache.end(); ++it) {
+		delete it->second;
+	}
+	stringCache.clear();
+	stringCacheIndex.clear();
+	stringCacheSize = 0;
+}
+
 //when copying the token, skip spaces
 inline const char* mystrncpy(char* dest, const char* source, int maxlength,
 	char delim)
@@ -416,22 +454,69 @@ ieStrRef TLKImporter::UpdateString(ieStrRef strref, const char *newvalue)
 
 String* TLKImporter::GetString(ieStrRef strref, ieDword flags)
 {
-	char* cstr = GetCString(strref, flags);
+	// the sound flags don't change the text
+	StringKey key(strref, flags & (IE_STR_STRREFON|IE_STR_REMOVE_NEWLINE|IE_STR_ALLOW_ZERO));
+	StringCacheIndex::iterator it = stringCacheIndex.find(key);
+	if (it != stringCacheIndex.end()) {
+		cacheHits++;
+		stringCache.splice(stringCache.begin(), stringCache, it->second);
+		PlayEntrySound(entries[strref], flags);
+		return new String(*it->second->second);
+	}
+
+	bool cacheable;
+	char* cstr = DecodeString(strref, flags, cacheable);
 	String* string = StringFromCString(cstr);
 	free(cstr);
+	if (!cacheable || !string) {
+		return string;
+	}
+
+	cacheMisses++;
+	stringCache.push_front(std::make_pair(key, new String(*string)));
+	stringCacheIndex[key] = stringCache.begin();
+	stringCacheSize += string->length() * sizeof(wchar_t);
+	while (stringCacheSize > STRING_CACHE_SIZE && stringCache.size() > 1) {
+		String* old = stringCache.back().second;
+		stringCacheSize -= old->length() * sizeof(wchar_t);
+		stringCacheIndex.erase(stringCache.back().first);
+		stringCache.pop_back();
+		delete old;
+	}
 	return string;
 }
 
 char* TLKImporter::GetCString(ieStrRef strref, ieDword flags)
+{
+	bool cacheable;
+	return DecodeString(strref, flags, cacheable);
+}
+
+void TLKImporter::PlayEntrySound(const TLKEntry& entry, ieDword flags)
+{
+	if (( entry.type & 2 ) && ( flags & IE_STR_SOUND )) {
+		//if flags&IE_STR_SOUND play soundresref
+		if (entry.SoundResRef[0] != 0) {
+			int xpos = 0;
+			int ypos = 0;
+			unsigned int flag = GEM_SND_RELATIVE | (flags&(GEM_SND_SPEECH|GEM_SND_QUEUE));
+			//IE_STR_SPEECH will stop the previous sound source
+			core->GetAudioDrv()->Play( entry.SoundResRef, xpos, ypos, flag);
+		}
+	}
+}
+
+char* TLKImporter::DecodeString(ieStrRef strref, ieDword flags, bool& cacheable)
 {
 	char* string;
+	cacheable = false;
 	
 	if (!(flags&IE_STR_ALLOW_ZERO) && !strref) {
 		goto empty;
 	}
 	ieWord type;
 	int Length;
-	ieResRef SoundResRef;
+	const TLKEntry* entry;
 
 	if((strref>=STRREF_START) || (strref>=BIO_START && strref<=BIO_END) ) {
 empty:
@@ -443,19 +528,14 @@ empty:
 			string[0] = 0;
 		}
 		type = 0;
-		SoundResRef[0]=0;
+		entry = NULL;
 	} else {
-		ieDword Volume, Pitch, StrOffset;
-		ieDword l;
-		if (str->Seek( 18 + ( strref * 0x1A ), GEM_STREAM_START ) == GEM_ERROR) {
+		if (strref >= entries.size()) {
 			return strdup("");
 		}
-		str->ReadWord( &type );
-		str->ReadResRef( SoundResRef );
-		str->ReadDword( &Volume );
-		str->ReadDword( &Pitch );
-		str->ReadDword( &StrOffset );
-		str->ReadDword( &l );
+		entry = &entries[strref];
+		type = entry->type;
+		ieDword l = entry->Length;
 		if (l > 65535) {
 			Length = 65535; //safety limit, it could be a dword actually
 		}
@@ -464,7 +544,7 @@ empty:
 		}
 		
 		if (type & 1) {
-			str->Seek( StrOffset + Offset, GEM_STREAM_START );
+			str->Seek( entry->StrOffset + Offset, GEM_STREAM_START );
 			string = ( char * ) malloc( Length + 1 );
 			str->Read( string, Length );
 		} else {
@@ -474,12 +554,16 @@ empty:
 		string[Length] = 0; 
 	}
 
+	// only plain strings from the tlk itself can be reused, the others
+	// may change with the game state
+	cacheable = (entry != NULL);
 	//tagged text, bg1 and iwd don't mark them specifically, all entries are tagged
 	if (core->HasFeature( GF_ALL_STRINGS_TAGGED ) || ( type & 4 )) {
 		//GetNewStringLength will look in string and return true
 		//if the new Length will change due to tokens
 		//if there is no new length, we are done
 		while (GetNewStringLength( string, Length )) {
+			cacheable = false;
 			char* string2 = ( char* ) malloc( Length + 1 );
 			//ResolveTags will copy string to string2
 			ResolveTags( string2, string, Length );
@@ -487,15 +571,8 @@ empty:
 			string = string2;
 		}
 	}
-	if (( type & 2 ) && ( flags & IE_STR_SOUND )) {
-		//if flags&IE_STR_SOUND play soundresref
-		if (SoundResRef[0] != 0) {
-			int xpos = 0;
-			int ypos = 0;
-			unsigned int flag = GEM_SND_RELATIVE | (flags&(GEM_SND_SPEECH|GEM_SND_QUEUE));
-			//IE_STR_SPEECH will stop the previous sound source
-			core->GetAudioDrv()->Play( SoundResRef, xpos, ypos, flag);
-		}
+	if (entry) {
+		PlayEntrySound(*entry, flags);
 	}
 	if (flags & IE_STR_STRREFON) {
 		char* string2 = ( char* ) malloc( Length + 13 );
@@ -515,16 +592,11 @@ StringBlock TLKImporter::GetStringBlock(ieStrRef strref, unsigned int flags)
 	if (!(flags&IE_STR_ALLOW_ZERO) && !strref) {
 		goto empty;
 	}
-	if (strref >= StrRefCount) {
+	if (strref >= entries.size()) {
 empty:
 		return StringBlock();
 	}
-	ieWord type;
-	str->Seek( 18 + ( strref * 0x1A ), GEM_STREAM_START );
-	str->ReadWord( &type );
-	ieResRef soundRef;
-	str->ReadResRef( soundRef );
-	return StringBlock(GetString( strref, flags ), soundRef);
+	return StringBlock(GetString( strref, flags ), entries[strref].SoundResRef);
 }
 
 #include "plugindef.h"
@@ -25,6 +25,10 @@
 
 #include "TlkOverride.h"
 
+#include <list>
+#include <map>
+#include <vector>
+
 namespace GemRB {
 
 class TLKImporter : public StringMgr {
@@ -35,6 +39,25 @@ private:
 	ieDword StrRefCount, Offset;
 	CTlkOverride *override;
 
+	struct TLKEntry {
+		ieWord type;
+		ieResRef SoundResRef;
+		ieDword StrOffset;
+		ieDword Length;
+	};
+	/** the entry headers, read once on Open */
+	std::vector<TLKEntry> entries;
+
+	/** already converted strings without tokens, by strref and the flags
+		changing the text; most recently used first */
+	typedef std::pair<ieStrRef, ieDword> StringKey;
+	typedef std::list<std::pair<StringKey, String*> > StringCache;
+	typedef std::map<StringKey, StringCache::iterator> StringCacheIndex;
+	StringCache stringCache;
+	StringCacheIndex stringCacheIndex;
+	size_t stringCacheSize;
+	unsigned int cacheHits, cacheMisses;
+
 public:
 	TLKImporter(void);
 	~TLKImporter(void);
@@ -51,6 +74,10 @@ public:
 	StringBlock GetStringBlock(ieStrRef strref, unsigned int flags = 0);
 	void FreeString(char *str);
 private:
+	/** reads and resolves a string, cacheable is set if it had no tokens */
+	char* DecodeString(ieStrRef strref, ieDword flags, bool& cacheable);
+	void PlayEntrySound(const TLKEntry& entry, ieDword flags);
+	void ClearStringCache();
 	/** resolves day and monthname tokens */
 	void GetMonthName(int dayandmonth);
 	/** replaces tags in dest, don't exceed Length */
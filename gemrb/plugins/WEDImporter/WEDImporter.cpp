@@ -29,6 +29,7 @@
 #include "GameData.h"
 #include "Interface.h"
 #include "PluginMgr.h"
+#include "TileSet.h"
 #include "TileSetMgr.h"
 
 #if HAVE_UNISTD_H
@@ -91,6 +92,8 @@ bool WEDImporter::Open(DataStream* stream)
 		str->ReadDword( &o.TilemapOffset );
 		str->ReadDword( &o.TILOffset );
 		overlays.push_back( o );
+		//tilesets are big and streamed from disk, so just warm the file cache
+		gamedata->Prefetch(o.TilesetResRef, IE_TIS_CLASS_ID, false);
 	}
 	//Reading the Secondary Header
 	str->Seek( SecHeaderOffset, GEM_STREAM_START );
@@ -133,7 +136,10 @@ int WEDImporter::AddOverlay(TileMap *tm, Overlay *overlays, bool rain)
 	}
 	PluginHolder<TileSetMgr> tis(IE_TIS_CLASS_ID);
 	tis->Open( tisfile );
+	// the tiles are only decoded once they are drawn
+	TileSet* tileset = new TileSet( tis.get() );
 	TileOverlay *over = new TileOverlay( overlays->Width, overlays->Height );
+	over->SetTileSet( tileset );
 	for (int y = 0; y < overlays->Height; y++) {
 		for (int x = 0; x < overlays->Width; x++) {
 			str->Seek( overlays->TilemapOffset +
@@ -158,9 +164,9 @@ int WEDImporter::AddOverlay(TileMap *tm, Overlay *overlays, bool rain)
 			}
 			Tile* tile;
 			if (secondary == 0xffff) {
-				tile = tis->GetTile( indices, count );
+				tile = tileset->CreateTile( indices, count );
 			} else {
-				tile = tis->GetTile( indices, 1, &secondary );
+				tile = tileset->CreateTile( indices, 1, &secondary );
 				tile->anim[1]->fps = animspeed;
 			}
 			tile->anim[0]->fps = animspeed;